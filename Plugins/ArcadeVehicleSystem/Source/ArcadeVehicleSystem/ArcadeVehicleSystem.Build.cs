@@ -15,13 +15,16 @@ public class ArcadeVehicleSystem : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
-				"Slate",
-				"SlateCore",
 				"NavigationSystem",
 				"AIModule",
-				"CinematicCamera"
+				"CinematicCamera",
+				"ReplicationGraph",
+				"IrisCore",
+				"NetCore"
 			}
 			);
+
+		SetupIrisSupport(Target);
 		
 #if UE_5_6_OR_LATER
 		PublicDefinitions.Add("UE_5_6_OR_LATER=1");
@@ -26,10 +26,30 @@ void UArcadeVehicleAnimationInstance::NativeUpdateAnimation(float DeltaSeconds)
 		return;
 	}
 
-	/* Perform wheels-related calculations. */
-	CalculateWheelsDirection(DeltaSeconds);
-	CalculateWheelsRotation(DeltaSeconds);
-	CalculateWheelsOffsets(DeltaSeconds);
+	/* Allocate wheel rotations if they are not present. */
+	AllocateWheels(m_pVehicleMovementComponent->GetVehicleSettings().Suspension);
+
+	/* Take snapshot of the vehicle here on the game thread. Everything else is calculated from it, possibly on a worker thread. */
+	Snapshot.Capture(*m_pVehicleMovementComponent);
+}
+
+void UArcadeVehicleAnimationInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	/* Nothing to animate until the first snapshot is taken, with the wheels allocated for it. */
+	if (!Snapshot.bIsValid || Settings.Wheels.Registry.Num() != Snapshot.Wheels.Num())
+	{
+		return;
+	}
+
+	/* Perform wheels-related calculations. Dedicated server renders no wheels, so it only needs the body, which the wheels are placed relative to. */
+	if (!IsRunningDedicatedServer())
+	{
+		CalculateWheelsDirection(DeltaSeconds);
+		CalculateWheelsRotation(DeltaSeconds);
+		CalculateWheelsOffsets(DeltaSeconds);
+	}
 
 	/* Perform body-related calculations. */
 	CalculateTilt(DeltaSeconds);
@@ -49,7 +69,7 @@ UArcadeVehicleMovementComponent* UArcadeVehicleAnimationInstance::GetVehicleMove
 void UArcadeVehicleAnimationInstance::CalculateWheelsDirection(float DeltaTime)
 {
 	/* Calculate wheels direction using raw input. */
-	const float turningInput = m_pVehicleMovementComponent->GetTurningInput();
+	const float turningInput = Snapshot.TurningInput;
 	float currentWheelsDirection = turningInput * Settings.Wheels.MaxDirection;
 
 	/* Check if wheels direction has changed - it most likely has. */
@@ -94,26 +114,20 @@ void UArcadeVehicleAnimationInstance::CalculateWheelsDirection(float DeltaTime)
 void UArcadeVehicleAnimationInstance::CalculateWheelsRotation(float DeltaTime)
 {
 	/* Rotation multiplier based on the vehicle direction. */
-	const float rotationDirection = m_pVehicleMovementComponent->IsMovingBackward() ? 1.f : -1.f;
-
-	/* Cache vehicle vehicleSettings. */
-	const FVehicleSettings& vehicleSettings = m_pVehicleMovementComponent->GetVehicleSettings();
-
-	/* Allocate wheel rotations if they are not present. */
-	AllocateWheels(vehicleSettings.Suspension);
+	const float rotationDirection = Snapshot.bIsMovingBackward ? 1.f : -1.f;
 
 	/* Check if wheels event should ever rotate. */
-	const bool bShouldRotateWheels = !Settings.Wheels.bStopRotationOnBraking || !m_pVehicleMovementComponent->IsBraking() || m_pVehicleMovementComponent->IsEngineBraking();
+	const bool bShouldRotateWheels = !Settings.Wheels.bStopRotationOnBraking || !Snapshot.bIsBraking || Snapshot.bIsEngineBraking;
 
 	/* If vehicle is running - its speed isn't 0. */
-	if (bShouldRotateWheels && m_pVehicleMovementComponent->GetCurrentSpeed() != 0.f)
+	if (bShouldRotateWheels && Snapshot.CurrentSpeed != 0.f)
 	{
 		/* Calculate speed absolute. */
-		const float currentSpeedAbsolute = FMath::Abs(m_pVehicleMovementComponent->GetCurrentSpeed());
+		const float currentSpeedAbsolute = FMath::Abs(Snapshot.CurrentSpeed);
 		
 		/* Iterate over all springs. */
 		int32 springIndex = INDEX_NONE;
-		for (const FVehicleSuspensionSpring& spring : vehicleSettings.Suspension.Springs)
+		for (const FVehicleWheelSnapshot& spring : Snapshot.Wheels)
 		{
 			/* Bump up spring index. */
 			springIndex++;
@@ -132,35 +146,29 @@ void UArcadeVehicleAnimationInstance::CalculateWheelsRotation(float DeltaTime)
 
 void UArcadeVehicleAnimationInstance::CalculateWheelsOffsets(float DeltaTime)
 {
-	/* Cache vehicle vehicleSettings. */
-	const FVehicleSettings& vehicleSettings = m_pVehicleMovementComponent->GetVehicleSettings();
-
 	/* Iterate over all wheels. */
-	for (int32 i = 0; i < vehicleSettings.Suspension.Springs.Num(); ++i)
+	for (int32 i = 0; i < Snapshot.Wheels.Num(); ++i)
 	{
 		/* Fill wheels with spring data. */
-		Settings.Wheels.Registry[i].Offset = vehicleSettings.Suspension.Springs[i].WheelOffset;
-		Settings.Wheels.Registry[i].Swing = vehicleSettings.Suspension.Springs[i].CurrentSwing;
+		Settings.Wheels.Registry[i].Offset = Snapshot.Wheels[i].WheelOffset;
+		Settings.Wheels.Registry[i].Swing = Snapshot.Wheels[i].CurrentSwing;
 	}
 }
 
 void UArcadeVehicleAnimationInstance::CalculateTilt(float DeltaTime)
 {
-	/* Cache vehicle vehicleSettings. */
-	const FVehicleSettings& vehicleSettings = m_pVehicleMovementComponent->GetVehicleSettings();
-
 	/* Check current acceleration and braking flags of the vehicle. */
-	const bool bIsAccelerating = m_pVehicleMovementComponent->IsAccelerating();
-	const bool bIsBraking = m_pVehicleMovementComponent->IsBraking();
+	const bool bIsAccelerating = Snapshot.bIsAccelerating;
+	const bool bIsBraking = Snapshot.bIsBraking;
 
 	/* Grab vehicle movement direction multiplier. */
-	const float movementDirectionMultiplier = FMath::Sign(m_pVehicleMovementComponent->GetLastAppliedAcceleration());
+	const float movementDirectionMultiplier = FMath::Sign(Snapshot.LastAppliedAcceleration);
 
 	/* Cache last known acceleration absolute value. */
-	const float accelerationAbsolute = FMath::Abs(m_pVehicleMovementComponent->GetLastAppliedAcceleration());
+	const float accelerationAbsolute = FMath::Abs(Snapshot.LastAppliedAcceleration);
 
 	/* Cache last known braking absolute value. */
-	const float brakingAbsolute = FMath::Abs(m_pVehicleMovementComponent->GetLastAppliedBraking());
+	const float brakingAbsolute = FMath::Abs(Snapshot.LastAppliedBraking);
 
 	/* Check if the tilt should be reset. That is when we start accelerating or start braking. */
 	const bool bShouldResetTilt = (bIsAccelerating && !m_bWasAccelerating) || (bIsBraking && !m_bWasBraking);
@@ -180,7 +188,7 @@ void UArcadeVehicleAnimationInstance::CalculateTilt(float DeltaTime)
 
 		/* Acceleration tilt is stronger with lower speeds, but the braking tilt is stronger when speeds are higher. */
 		/* Correct tilt speed value by calculating speed ratio. */
-		float speedRatio = FMath::Clamp(FMath::Abs(m_pVehicleMovementComponent->GetCurrentSpeed() / Settings.Tilt.RuntimeTilt.TiltDampingSpeed), 0.f, 1.f);
+		float speedRatio = FMath::Clamp(FMath::Abs(Snapshot.CurrentSpeed / Settings.Tilt.RuntimeTilt.TiltDampingSpeed), 0.f, 1.f);
 		speedRatio = bIsAccelerating ? 1.f - speedRatio : speedRatio;
 		Settings.Tilt.RuntimeTilt.Speed *= speedRatio;
 
@@ -199,11 +207,8 @@ void UArcadeVehicleAnimationInstance::CalculateTilt(float DeltaTime)
 
 void UArcadeVehicleAnimationInstance::CalculateRoll(float DeltaTime)
 {
-	/* Cache vehicle vehicleSettings. */
-	const FVehicleSettings& vehicleSettings = m_pVehicleMovementComponent->GetVehicleSettings();
-
 	/* Calculate wheel slip by calculating ratio of the side linear velocity axis and value provided. */
-	float wheelSlip = FMath::Clamp((m_pVehicleMovementComponent->GetLocalLinearVelocity().Y * KMH_MULTIPLIER) / Settings.Roll.RollDampingSpeed, -1.f, 1.f);
+	float wheelSlip = FMath::Clamp((Snapshot.LocalLinearVelocity.Y * KMH_MULTIPLIER) / Settings.Roll.RollDampingSpeed, -1.f, 1.f);
 	wheelSlip *= Settings.Roll.MaxAngle;
 
 	/* Calculate final roll value. */
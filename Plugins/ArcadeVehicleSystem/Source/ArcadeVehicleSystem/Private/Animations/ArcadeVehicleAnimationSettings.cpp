@@ -1,6 +1,7 @@
 /** Created and owned by Furious Production LTD @ 2023. **/
 
 #include "Animations/ArcadeVehicleAnimationSettings.h"
+#include "Movement/ArcadeVehicleMovementComponentBase.h"
 
 FVehicleWheelAnimationInfo::FVehicleWheelAnimationInfo()
 {
@@ -47,3 +48,40 @@ FVehicleAnimationRollSettings::FVehicleAnimationRollSettings()
 	Strength = 5.f;
 	RollDampingSpeed = 150.f;
 }
+
+FVehicleAnimationSnapshot::FVehicleAnimationSnapshot()
+{
+	bIsValid = false;
+	TurningInput = 0.f;
+	CurrentSpeed = 0.f;
+	LastAppliedAcceleration = 0.f;
+	LastAppliedBraking = 0.f;
+	LocalLinearVelocity = FVector::ZeroVector;
+	bIsMovingBackward = false;
+	bIsAccelerating = false;
+	bIsBraking = false;
+	bIsEngineBraking = false;
+}
+
+void FVehicleAnimationSnapshot::Capture(const UArcadeVehicleMovementComponentBase& Vehicle)
+{
+	bIsValid = true;
+	TurningInput = Vehicle.GetTurningInput();
+	CurrentSpeed = Vehicle.GetCurrentSpeed();
+	LastAppliedAcceleration = Vehicle.GetLastAppliedAcceleration();
+	LastAppliedBraking = Vehicle.GetLastAppliedBraking();
+	LocalLinearVelocity = Vehicle.GetLocalLinearVelocity();
+	bIsMovingBackward = Vehicle.IsMovingBackward();
+	bIsAccelerating = Vehicle.IsAccelerating();
+	bIsBraking = Vehicle.IsBraking();
+	bIsEngineBraking = Vehicle.IsEngineBraking();
+
+	const TArray<FVehicleSuspensionSpring>& springs = Vehicle.GetVehicleSettings().Suspension.Springs;
+	Wheels.SetNumUninitialized(springs.Num());
+	for(int32 i = 0; i < springs.Num(); ++i)
+	{
+		Wheels[i].TargetHeight = springs[i].TargetHeight;
+		Wheels[i].WheelOffset = springs[i].WheelOffset;
+		Wheels[i].CurrentSwing = springs[i].CurrentSwing;
+	}
+}
@@ -1,24 +1,24 @@
 ﻿/** Created and owned by Furious Production LTD @ 2023. **/
 
 #include "Animations/StaticArcadeVehicleAnimator.h"
+#include "Animations/StaticArcadeVehicleAnimatorSubsystem.h"
 #include "Movement/StaticArcadeVehicleMovementComponent.h"
 #include "Components/StaticMeshComponent.h"
 
 UStaticArcadeVehicleAnimator::UStaticArcadeVehicleAnimator()
 {
-	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = false;
+	/* Animators are updated in batch by the subsystem. */
+	PrimaryComponentTick.bCanEverTick = false;
 	
+	bCalculateOnGameThread = false;
 	m_bWasAccelerating = false;
 	m_bWasBraking = false;
+	m_BodyRotation = FRotator::ZeroRotator;
 }
 
 void UStaticArcadeVehicleAnimator::BeginPlay()
 {
 	Super::BeginPlay();
-
-	/* Disallow ticking. */
-	SetComponentTickEnabled(false);
 	
 	/* Make sure we have vehicle movement component. */
 	if(!IsValid(GetVehicleMovementComponent()))
@@ -37,20 +37,44 @@ void UStaticArcadeVehicleAnimator::BeginPlay()
 	/* Cache vehicle vehicleSettings. */
 	const FVehicleSettings& vehicleSettings = GetVehicleMovementComponent()->GetVehicleSettings();
 	
-	/* Allocate wheel rotations if they are not present. */
-	if(AllocateWheels(vehicleSettings.Suspension))
+	/* Allocate wheel rotations if they are not present. Dedicated server renders nothing, so it never animates. */
+	if(AllocateWheels(vehicleSettings.Suspension) && !IsRunningDedicatedServer())
 	{
-		/* Enable ticking as we have successfully allocated wheels. */
-		SetComponentTickEnabled(true);
+		/* Start animating as we have successfully allocated wheels. */
+		if(UStaticArcadeVehicleAnimatorSubsystem* pAnimatorSubsystem = GetWorld()->GetSubsystem<UStaticArcadeVehicleAnimatorSubsystem>())
+		{
+			pAnimatorSubsystem->RegisterAnimator(this);
+		}
 	}
 }
 
-void UStaticArcadeVehicleAnimator::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UStaticArcadeVehicleAnimator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	/* Stop animating. */
+	if(UStaticArcadeVehicleAnimatorSubsystem* pAnimatorSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UStaticArcadeVehicleAnimatorSubsystem>() : nullptr)
+	{
+		pAnimatorSubsystem->UnregisterAnimator(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UStaticArcadeVehicleAnimator::CaptureSnapshot()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-	
 	/* Must have valid vehicle. */
 	if (!IsValid(GetVehicleMovementComponent()))
+	{
+		Snapshot.bIsValid = false;
+		return;
+	}
+
+	Snapshot.Capture(*m_pVehicleMovementComponent);
+}
+
+void UStaticArcadeVehicleAnimator::CalculateAnimation(float DeltaTime)
+{
+	/* Nothing to animate without snapshot matching the wheels. */
+	if (!Snapshot.bIsValid || Settings.Wheels.Registry.Num() != Snapshot.Wheels.Num())
 	{
 		return;
 	}
@@ -64,8 +88,8 @@ void UStaticArcadeVehicleAnimator::TickComponent(float DeltaTime, ELevelTick Tic
 	CalculateTilt(DeltaTime);
 	CalculateRoll(DeltaTime);
 
-	/* Apply animation in the end. */
-	ApplyAnimation();
+	/* Turn the results into mesh transforms, so applying them is just a copy. */
+	CalculateTransforms(DeltaTime);
 }
 
 UStaticArcadeVehicleMovementComponent* UStaticArcadeVehicleAnimator::GetVehicleMovementComponent()
@@ -81,7 +105,7 @@ UStaticArcadeVehicleMovementComponent* UStaticArcadeVehicleAnimator::GetVehicleM
 void UStaticArcadeVehicleAnimator::CalculateWheelsDirection(float DeltaTime)
 {
 	/* Calculate wheels direction using raw input. */
-	const float turningInput = m_pVehicleMovementComponent->GetTurningInput();
+	const float turningInput = Snapshot.TurningInput;
 	float currentWheelsDirection = turningInput * Settings.Wheels.MaxDirection;
 
 	/* Check if wheels direction has changed - it most likely has. */
@@ -126,23 +150,20 @@ void UStaticArcadeVehicleAnimator::CalculateWheelsDirection(float DeltaTime)
 void UStaticArcadeVehicleAnimator::CalculateWheelsRotation(float DeltaTime)
 {
 	/* Rotation multiplier based on the vehicle direction. */
-	const float rotationDirection = m_pVehicleMovementComponent->IsMovingBackward() ? 1.f : -1.f;
-
-	/* Cache vehicle vehicleSettings. */
-	const FVehicleSettings& vehicleSettings = m_pVehicleMovementComponent->GetVehicleSettings();
+	const float rotationDirection = Snapshot.bIsMovingBackward ? 1.f : -1.f;
 
 	/* Check if wheels event should ever rotate. */
-	const bool bShouldRotateWheels = !Settings.Wheels.bStopRotationOnBraking || !m_pVehicleMovementComponent->IsBraking() || m_pVehicleMovementComponent->IsEngineBraking();
+	const bool bShouldRotateWheels = !Settings.Wheels.bStopRotationOnBraking || !Snapshot.bIsBraking || Snapshot.bIsEngineBraking;
 
 	/* If vehicle is running - its speed isn't 0. */
-	if (bShouldRotateWheels && m_pVehicleMovementComponent->GetCurrentSpeed() != 0.f)
+	if (bShouldRotateWheels && Snapshot.CurrentSpeed != 0.f)
 	{
 		/* Calculate speed absolute. */
-		const float currentSpeedAbsolute = FMath::Abs(m_pVehicleMovementComponent->GetCurrentSpeed());
+		const float currentSpeedAbsolute = FMath::Abs(Snapshot.CurrentSpeed);
 		
 		/* Iterate over all springs. */
 		int32 springIndex = INDEX_NONE;
-		for (const FVehicleSuspensionSpring& spring : vehicleSettings.Suspension.Springs)
+		for (const FVehicleWheelSnapshot& spring : Snapshot.Wheels)
 		{
 			/* Bump up spring index. */
 			springIndex++;
@@ -161,35 +182,29 @@ void UStaticArcadeVehicleAnimator::CalculateWheelsRotation(float DeltaTime)
 
 void UStaticArcadeVehicleAnimator::CalculateWheelsOffsets(float DeltaTime)
 {
-	/* Cache vehicle vehicleSettings. */
-	const FVehicleSettings& vehicleSettings = m_pVehicleMovementComponent->GetVehicleSettings();
-
 	/* Iterate over all wheels. */
-	for (int32 i = 0; i < vehicleSettings.Suspension.Springs.Num(); ++i)
+	for (int32 i = 0; i < Snapshot.Wheels.Num(); ++i)
 	{
 		/* Fill wheels with spring data. */
-		Settings.Wheels.Registry[i].Offset = vehicleSettings.Suspension.Springs[i].WheelOffset;
-		Settings.Wheels.Registry[i].Swing = vehicleSettings.Suspension.Springs[i].CurrentSwing;
+		Settings.Wheels.Registry[i].Offset = Snapshot.Wheels[i].WheelOffset;
+		Settings.Wheels.Registry[i].Swing = Snapshot.Wheels[i].CurrentSwing;
 	}
 }
 
 void UStaticArcadeVehicleAnimator::CalculateTilt(float DeltaTime)
 {
-	/* Cache vehicle vehicleSettings. */
-	const FVehicleSettings& vehicleSettings = m_pVehicleMovementComponent->GetVehicleSettings();
-
 	/* Check current acceleration and braking flags of the vehicle. */
-	const bool bIsAccelerating = m_pVehicleMovementComponent->IsAccelerating();
-	const bool bIsBraking = m_pVehicleMovementComponent->IsBraking();
+	const bool bIsAccelerating = Snapshot.bIsAccelerating;
+	const bool bIsBraking = Snapshot.bIsBraking;
 
 	/* Grab vehicle movement direction multiplier. */
-	const float movementDirectionMultiplier = FMath::Sign(m_pVehicleMovementComponent->GetLastAppliedAcceleration());
+	const float movementDirectionMultiplier = FMath::Sign(Snapshot.LastAppliedAcceleration);
 
 	/* Cache last known acceleration absolute value. */
-	const float accelerationAbsolute = FMath::Abs(m_pVehicleMovementComponent->GetLastAppliedAcceleration());
+	const float accelerationAbsolute = FMath::Abs(Snapshot.LastAppliedAcceleration);
 
 	/* Cache last known braking absolute value. */
-	const float brakingAbsolute = FMath::Abs(m_pVehicleMovementComponent->GetLastAppliedBraking());
+	const float brakingAbsolute = FMath::Abs(Snapshot.LastAppliedBraking);
 
 	/* Check if the tilt should be reset. That is when we start accelerating or start braking. */
 	const bool bShouldResetTilt = (bIsAccelerating && !m_bWasAccelerating) || (bIsBraking && !m_bWasBraking);
@@ -209,7 +224,7 @@ void UStaticArcadeVehicleAnimator::CalculateTilt(float DeltaTime)
 
 		/* Acceleration tilt is stronger with lower speeds, but the braking tilt is stronger when speeds are higher. */
 		/* Correct tilt speed value by calculating speed ratio. */
-		float speedRatio = FMath::Clamp(FMath::Abs(m_pVehicleMovementComponent->GetCurrentSpeed() / Settings.Tilt.RuntimeTilt.TiltDampingSpeed), 0.f, 1.f);
+		float speedRatio = FMath::Clamp(FMath::Abs(Snapshot.CurrentSpeed / Settings.Tilt.RuntimeTilt.TiltDampingSpeed), 0.f, 1.f);
 		speedRatio = bIsAccelerating ? 1.f - speedRatio : speedRatio;
 		Settings.Tilt.RuntimeTilt.Speed *= speedRatio;
 
@@ -228,11 +243,8 @@ void UStaticArcadeVehicleAnimator::CalculateTilt(float DeltaTime)
 
 void UStaticArcadeVehicleAnimator::CalculateRoll(float DeltaTime)
 {
-	/* Cache vehicle vehicleSettings. */
-	const FVehicleSettings& vehicleSettings = m_pVehicleMovementComponent->GetVehicleSettings();
-
 	/* Calculate wheel slip by calculating ratio of the side linear velocity axis and value provided. */
-	float wheelSlip = FMath::Clamp((m_pVehicleMovementComponent->GetLocalLinearVelocity().Y * KMH_MULTIPLIER) / Settings.Roll.RollDampingSpeed, -1.f, 1.f);
+	float wheelSlip = FMath::Clamp((Snapshot.LocalLinearVelocity.Y * KMH_MULTIPLIER) / Settings.Roll.RollDampingSpeed, -1.f, 1.f);
 	wheelSlip *= Settings.Roll.MaxAngle;
 
 	/* Calculate final roll value. */
@@ -283,20 +295,19 @@ bool UStaticArcadeVehicleAnimator::AllocateWheels(const FVehicleSuspensionSettin
 	return true;
 }
 
-void UStaticArcadeVehicleAnimator::ApplyAnimation_Implementation()
+void UStaticArcadeVehicleAnimator::CalculateTransforms(float DeltaTime)
 {
-	/* Grab visuals mesh. */
-	UStaticMeshComponent* pVehicleMesh = GetVehicleMovementComponent()->GetVisualsMesh();
-
-	/* Apply suspension rotation for the tilt and roll. */
-	FRotator suspensionRotation = FRotator::ZeroRotator;
-	suspensionRotation.Roll = Settings.Roll.CurrentRoll;
-	suspensionRotation.Pitch = Settings.Tilt.CurrentTilt;
-	pVehicleMesh->SetRelativeRotation(suspensionRotation);
+	/* Suspension rotation for the tilt and roll. */
+	m_BodyRotation = FRotator::ZeroRotator;
+	m_BodyRotation.Roll = Settings.Roll.CurrentRoll;
+	m_BodyRotation.Pitch = Settings.Tilt.CurrentTilt;
 
 	/* Rotate wheels. */
-	for(FVehicleWheelAnimationInfo& wheel : Settings.Wheels.Registry)
+	m_WheelTransforms.SetNumUninitialized(Settings.Wheels.Registry.Num());
+	for(int32 i = 0; i < Settings.Wheels.Registry.Num(); ++i)
 	{
+		const FVehicleWheelAnimationInfo& wheel = Settings.Wheels.Registry[i];
+
 		/* Prepare rotator. Use wheel direction if the wheel is steering wheel. */
 		FRotator wheelRotation = wheel.InitialWheelMeshTransform.GetRotation().Rotator();
 
@@ -314,16 +325,43 @@ void UStaticArcadeVehicleAnimator::ApplyAnimation_Implementation()
 		FRotator rollRotator(0.f, 0.f, wheel.Swing);
 		wheelRotation = (rollRotator.Quaternion() * wheelRotation.Quaternion()).Rotator();
 
-		/* Apply wheel rotation. */
-		wheel.WheelMesh->SetRelativeRotation(wheelRotation);
+		/* Store wheel rotation. */
+		m_WheelTransforms[i].Rotation = wheelRotation;
 
 		/* Prepare wheel offset. */
 		FVector wheelOffset = wheel.InitialWheelMeshTransform.GetLocation();
 		wheelOffset.Z += wheel.Offset;
 
-		/* Apply wheel offset. */
-		wheel.WheelMesh->SetRelativeLocation(wheelOffset);
+		/* Store wheel offset. */
+		m_WheelTransforms[i].Location = wheelOffset;
+	}
+}
 
-		
+void UStaticArcadeVehicleAnimator::ApplyAnimation_Implementation()
+{
+	/* Must have calculated transforms for all wheels. */
+	if (!IsValid(GetVehicleMovementComponent()) || m_WheelTransforms.Num() != Settings.Wheels.Registry.Num())
+	{
+		return;
 	}
+
+	/* Grab visuals mesh. */
+	UStaticMeshComponent* pVehicleMesh = GetVehicleMovementComponent()->GetVisualsMesh();
+
+	/* Wheels only get their relative transforms here, without updating them one by one. */
+	for(int32 i = 0; i < Settings.Wheels.Registry.Num(); ++i)
+	{
+		UStaticMeshComponent* pWheelMesh = Settings.Wheels.Registry[i].WheelMesh.Get();
+		if(!IsValid(pWheelMesh))
+		{
+			continue;
+		}
+
+		pWheelMesh->SetRelativeLocation_Direct(m_WheelTransforms[i].Location);
+		pWheelMesh->SetRelativeRotation_Direct(m_WheelTransforms[i].Rotation);
+	}
+
+	/* Wheels are attached to the visuals mesh, so single update of it propagates to all of them. */
+	pVehicleMesh->SetRelativeRotation_Direct(m_BodyRotation);
+	pVehicleMesh->UpdateComponentToWorld();
 }
@@ -0,0 +1,153 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#include "Animations/StaticArcadeVehicleAnimatorSubsystem.h"
+#include "Animations/StaticArcadeVehicleAnimator.h"
+#include "Movement/ArcadeVehicleMovementComponentBase.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace StaticArcadeVehicleAnimatorSubsystem
+{
+	/** Min number of animators calculated by single worker, so small batches don't pay for the task overhead. */
+	static constexpr int32 MinBatchSize = 8;
+
+	/** Number of wheels of every synthetic vehicle in the benchmark. */
+	static constexpr int32 BenchmarkWheels = 4;
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("avs.Animation.Benchmark"),
+		TEXT("Calculates animation of synthetic static vehicles, serially and in parallel, and logs the timings. Arguments: [Vehicles] [Frames]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(const UStaticArcadeVehicleAnimatorSubsystem* pAnimatorSubsystem = World ? World->GetSubsystem<UStaticArcadeVehicleAnimatorSubsystem>() : nullptr)
+			{
+				pAnimatorSubsystem->RunBenchmark(
+					Args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100,
+					Args.IsValidIndex(1) ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1000);
+			}
+		}));
+}
+
+void UStaticArcadeVehicleAnimatorSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	/* Drop animators that are gone, and capture snapshots of the rest. Movement components can only be read on the game thread. */
+	for(int32 i = Animators.Num() - 1; i >= 0; --i)
+	{
+		UStaticArcadeVehicleAnimator* pAnimator = Animators[i];
+		if(!IsValid(pAnimator))
+		{
+#if UE_5_6_OR_LATER
+			Animators.RemoveAtSwap(i, 1, EAllowShrinking::No);
+#else
+			Animators.RemoveAtSwap(i, 1, false);
+#endif
+			continue;
+		}
+
+		pAnimator->CaptureSnapshot();
+	}
+
+	/* Calculate the animators on the worker threads, except those that have to stay on the game thread. */
+	CalculateAnimators(Animators, DeltaTime, true);
+
+	/* Apply calculated transforms in single pass. */
+	for(UStaticArcadeVehicleAnimator* pAnimator : Animators)
+	{
+		pAnimator->ApplyAnimation();
+	}
+}
+
+TStatId UStaticArcadeVehicleAnimatorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UStaticArcadeVehicleAnimatorSubsystem, STATGROUP_Tickables);
+}
+
+bool UStaticArcadeVehicleAnimatorSubsystem::IsTickable() const
+{
+	return Animators.Num() > 0;
+}
+
+void UStaticArcadeVehicleAnimatorSubsystem::RegisterAnimator(UStaticArcadeVehicleAnimator* Animator)
+{
+	if(IsValid(Animator))
+	{
+		Animators.AddUnique(Animator);
+	}
+}
+
+void UStaticArcadeVehicleAnimatorSubsystem::UnregisterAnimator(UStaticArcadeVehicleAnimator* Animator)
+{
+	Animators.RemoveSwap(Animator);
+}
+
+void UStaticArcadeVehicleAnimatorSubsystem::CalculateAnimators(const TArray<UStaticArcadeVehicleAnimator*>& InAnimators, float DeltaTime, bool bParallel)
+{
+	/* Animators that opted out of the worker threads are calculated on the game thread once the batch is done. */
+	ParallelFor(TEXT("StaticArcadeVehicleAnimators"), InAnimators.Num(), StaticArcadeVehicleAnimatorSubsystem::MinBatchSize, [&InAnimators, DeltaTime](int32 Index)
+	{
+		if(!InAnimators[Index]->bCalculateOnGameThread)
+		{
+			InAnimators[Index]->CalculateAnimation(DeltaTime);
+		}
+	}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	for(UStaticArcadeVehicleAnimator* pAnimator : InAnimators)
+	{
+		if(pAnimator->bCalculateOnGameThread)
+		{
+			pAnimator->CalculateAnimation(DeltaTime);
+		}
+	}
+}
+
+void UStaticArcadeVehicleAnimatorSubsystem::RunBenchmark(int32 Vehicles, int32 Frames) const
+{
+	/* Synthetic animators aren't registered anywhere, they only carry the data the calculations need. */
+	FRandomStream random(Vehicles);
+	TArray<UStaticArcadeVehicleAnimator*> animators;
+	animators.Reserve(Vehicles);
+	for(int32 i = 0; i < Vehicles; ++i)
+	{
+		UStaticArcadeVehicleAnimator* pAnimator = NewObject<UStaticArcadeVehicleAnimator>(GetTransientPackage());
+		pAnimator->Settings.Wheels.Registry.SetNum(StaticArcadeVehicleAnimatorSubsystem::BenchmarkWheels);
+		pAnimator->Snapshot.Wheels.SetNumZeroed(StaticArcadeVehicleAnimatorSubsystem::BenchmarkWheels);
+		for(int32 wheelIndex = 0; wheelIndex < StaticArcadeVehicleAnimatorSubsystem::BenchmarkWheels; ++wheelIndex)
+		{
+			pAnimator->Settings.Wheels.Registry[wheelIndex].bIsSteeringWheel = wheelIndex < 2;
+			pAnimator->Snapshot.Wheels[wheelIndex].TargetHeight = 35.f;
+		}
+
+		pAnimator->Snapshot.bIsValid = true;
+		pAnimator->Snapshot.CurrentSpeed = random.FRandRange(0.f, 200.f);
+		pAnimator->Snapshot.LastAppliedAcceleration = random.FRandRange(0.f, 1.f);
+		pAnimator->Snapshot.bIsAccelerating = true;
+		animators.Add(pAnimator);
+	}
+
+	/* Inputs change every frame, so the wheels keep steering. */
+	auto runFrames = [&animators, &random, Frames](bool bParallel)
+	{
+		const double startTime = FPlatformTime::Seconds();
+		for(int32 frame = 0; frame < Frames; ++frame)
+		{
+			for(UStaticArcadeVehicleAnimator* pAnimator : animators)
+			{
+				pAnimator->Snapshot.TurningInput = random.FRandRange(-1.f, 1.f);
+				pAnimator->Snapshot.LocalLinearVelocity.Y = random.FRandRange(-500.f, 500.f);
+			}
+			CalculateAnimators(animators, 1.f / 60.f, bParallel);
+		}
+		return FPlatformTime::Seconds() - startTime;
+	};
+
+	const double serialTime = runFrames(false);
+	const double parallelTime = runFrames(true);
+
+	const double toMicroseconds = 1000000.0 / Frames;
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("Static animation benchmark: %d vehicles, %d frames, %d registered animators."), Vehicles, Frames, Animators.Num());
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("  Serial: %.2fus per frame"), serialTime * toMicroseconds);
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("  Parallel: %.2fus per frame"), parallelTime * toMicroseconds);
+}
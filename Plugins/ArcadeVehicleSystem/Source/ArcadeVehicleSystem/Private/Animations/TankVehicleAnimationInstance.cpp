@@ -14,29 +14,23 @@ UTankVehicleAnimationInstance::UTankVehicleAnimationInstance()
 void UTankVehicleAnimationInstance::CalculateWheelsRotation(float DeltaTime)
 {
 	/* Rotation multiplier based on the vehicle direction. */
-	const float rotationDirection = m_pVehicleMovementComponent->IsMovingBackward() ? 1.f : -1.f;
-
-	/* Cache vehicle vehicleSettings. */
-	const FVehicleSettings& vehicleSettings = m_pVehicleMovementComponent->GetVehicleSettings();
-
-	/* Allocate wheel rotations if they are not present. */
-	AllocateWheels(vehicleSettings.Suspension);
+	const float rotationDirection = Snapshot.bIsMovingBackward ? 1.f : -1.f;
 
 	/* Check if wheels event should ever rotate. */
-	const bool bShouldRotateWheels = !Settings.Wheels.bStopRotationOnBraking || !m_pVehicleMovementComponent->IsBraking() || m_pVehicleMovementComponent->IsEngineBraking();
+	const bool bShouldRotateWheels = !Settings.Wheels.bStopRotationOnBraking || !Snapshot.bIsBraking || Snapshot.bIsEngineBraking;
 
 	/* Rotate wheels if allowed. */
 	if (bShouldRotateWheels)
 	{
 		/* Calculate speed absolute. */
-		const float currentSpeedAbsolute = FMath::Abs(m_pVehicleMovementComponent->GetCurrentSpeed());
+		const float currentSpeedAbsolute = FMath::Abs(Snapshot.CurrentSpeed);
 
 		/* Cache vehicle turning input. */
-		const float turningInput = m_pVehicleMovementComponent->GetTurningInput();
+		const float turningInput = Snapshot.TurningInput;
 
 		/* Iterate over all springs. */
 		int32 springIndex = INDEX_NONE;
-		for (const FVehicleSuspensionSpring& spring : vehicleSettings.Suspension.Springs)
+		for (const FVehicleWheelSnapshot& spring : Snapshot.Wheels)
 		{
 			/* Bump up spring index. */
 			springIndex++;
@@ -51,7 +45,7 @@ void UTankVehicleAnimationInstance::CalculateWheelsRotation(float DeltaTime)
 			}
 
 			/* If the speed is zero. */
-			if (FMath::IsNearlyZero(m_pVehicleMovementComponent->GetCurrentSpeed(), VehicleSpeedForInverseWheelRotation))
+			if (FMath::IsNearlyZero(Snapshot.CurrentSpeed, VehicleSpeedForInverseWheelRotation))
 			{
 				/* If turning in any direction. */
 				if(turningInput != 0.f)
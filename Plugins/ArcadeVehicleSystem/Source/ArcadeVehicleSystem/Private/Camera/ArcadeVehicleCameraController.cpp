@@ -20,6 +20,9 @@ UArcadeVehicleCameraController::UArcadeVehicleCameraController()
 	/* Camera controller should always use absolute rotation to avoid up-side-down camera when entering the vehicle. */
 	SetUsingAbsoluteRotation(true);
 
+	/* Nobody looks through the cameras on the dedicated server. */
+	PrimaryComponentTick.bAllowTickOnDedicatedServer = false;
+
 	/* Mostly constant values. */
 	CameraPossessingBlendTime = 1.15f;
 	bUseRotationSnapping = true;
@@ -3,6 +3,8 @@
 #include "Movement/ArcadeVehicleMovementComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkinnedAsset.h"
+#include "AnimationRuntime.h"
 
 bool UArcadeVehicleMovementComponent::InitializeVehicleMovement()
 {
@@ -28,6 +30,14 @@ bool UArcadeVehicleMovementComponent::InitializeVehicleMovement()
 
 bool UArcadeVehicleMovementComponent::RegisterSuspensionSprings()
 {
+	/* Suspension is taken from the reference pose, since pose of the mesh isn't refreshed on dedicated servers, which render nothing. */
+	const USkinnedAsset* pSkinnedAsset = m_pVehicleSkeletalMesh->GetSkinnedAsset();
+	if (!IsValid(pSkinnedAsset))
+	{
+		UE_LOG(LogArcadeVehicleMovement, Error, TEXT("Arcade vehicle skeletal mesh has no mesh asset assigned!"));
+		return false;
+	}
+
 	/* Iterate over all bones to register suspension locations. */
 	for (FVehicleSuspensionSpring& spring : Settings.Suspension.Springs)
 	{
@@ -39,7 +49,7 @@ bool UArcadeVehicleMovementComponent::RegisterSuspensionSprings()
 		if (boneIndex != INDEX_NONE)
 		{
 			/* Grab bone location and apply it to the iterated spring. */
-			spring.Location = m_pVehicleSkeletalMesh->GetBoneLocation(boneName, EBoneSpaces::ComponentSpace);			
+			spring.Location = FAnimationRuntime::GetComponentSpaceTransformRefPose(pSkinnedAsset->GetRefSkeleton(), boneIndex).GetLocation();
 		}
 		else
 		{
@@ -59,6 +69,14 @@ bool UArcadeVehicleMovementComponent::RegisterSuspensionSprings()
 		UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("Suspension parent bone not specified or not found. Suspension bones will be transformed by the vehicle root."));
 	}
 
+	/* Dedicated server renders nothing, so the pose is only refreshed for the suspension parent bone, which the wheels are placed relative to. */
+	if (IsRunningDedicatedServer())
+	{
+		m_pVehicleSkeletalMesh->VisibilityBasedAnimTickOption = Settings.Suspension.SuspensionParentBoneIndex != INDEX_NONE
+			? EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones
+			: EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	}
+
 	/* Implemented and successful. */
 	return true;
 }
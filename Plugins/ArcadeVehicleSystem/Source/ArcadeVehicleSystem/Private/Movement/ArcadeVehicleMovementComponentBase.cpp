@@ -2,12 +2,18 @@
 
 #include "Movement/ArcadeVehicleMovementComponentBase.h"
 #include "GameFramework/PlayerState.h"
+#include "GameFramework/PlayerController.h"
 #include "GameFramework/Pawn.h"
 #include "Components/PrimitiveComponent.h"
 #include "Curves/CurveFloat.h"
 #include "Movement/ArcadeVehiclePathFollowingComponent.h"
+#include "Networking/ArcadeVehicleStateManager.h"
+#include "Networking/ArcadeVehicleClockSyncComponent.h"
+#include "Networking/ArcadeVehicleLagCompensation.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Engine/World.h"
+#include "Engine/NetDriver.h"
 #include "CollisionQueryParams.h"
 #include "CollisionShape.h"
 
@@ -41,16 +47,81 @@ UArcadeVehicleMovementComponentBase::UArcadeVehicleMovementComponentBase()
 
 	/* Internal data. */
 	bIsVehicleInitialized = false;
-	LastTeleportTime = 0.f;
+	bIsKinematicProxy = false;
+	bIsStandalone = false;
+	bHasControlOverVehicle = false;
+	LastTeleportTime = 0.0;
+	LastKeyframeTime = TNumericLimits<double>::Lowest();
+	DormancyReferenceTime = TNumericLimits<double>::Lowest();
+	bHasReceivedState = false;
+	SimulatedInputSequence = 0;
+	bHasNewInputSequence = false;
+	bIsResimulating = false;
+	InputStepAccumulator = 0.f;
+	RemoteMovementModifiers = 0;
 	CustomGravity = FVector::ZeroVector;
 }
 
 void UArcadeVehicleMovementComponentBase::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	/* Offline sessions never change their net mode, so it is checked only once. Settings skip network allocations based on it. */
+	bIsStandalone = GetNetMode() == NM_Standalone;
+
 	/* Apply vehicle settings in full. */
 	ApplyVehicleSettings();
+	UpdateControlRole();
+
+	/* Possession changes refresh the control role right away, instead of waiting for the next tick. */
+	if(APawn* pPawn = GetPawnOwner())
+	{
+		pPawn->ReceiveControllerChangedDelegate.AddUniqueDynamic(this, &UArcadeVehicleMovementComponentBase::OnControllerChanged);
+	}
+
+	/* Collisions wake the vehicle from net dormancy. */
+	if(Settings.Network.bEnableNetDormancy && !bIsStandalone && IsValid(PhysicsPrimitive))
+	{
+		PhysicsPrimitive->OnComponentHit.AddUniqueDynamic(this, &UArcadeVehicleMovementComponentBase::OnVehicleHit);
+	}
+
+	/* Record history of this vehicle for the server-side lag compensation. */
+	if(GetOwnerRole() == ROLE_Authority && !bIsStandalone)
+	{
+		if(UArcadeVehicleLagCompensationSubsystem* pLagCompensation = GetWorld()->GetSubsystem<UArcadeVehicleLagCompensationSubsystem>())
+		{
+			pLagCompensation->RegisterVehicle(this);
+		}
+	}
+
+	/* Batched states can't be filtered per connection, so replication graph takes over their relevancy. */
+	if(Settings.Network.bBatchStateReplication && GetOwnerRole() == ROLE_Authority && !bIsStandalone && !IsBatchingStates())
+	{
+		UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("%s: batched state replication is ignored, as the net driver uses a replication driver."), *GetNameSafe(GetOwner()));
+	}
+}
+
+void UArcadeVehicleMovementComponentBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(APawn* pPawn = GetPawnOwner())
+	{
+		pPawn->ReceiveControllerChangedDelegate.RemoveDynamic(this, &UArcadeVehicleMovementComponentBase::OnControllerChanged);
+	}
+
+	/* Stop batching states of this vehicle. */
+	if(StateManager.IsValid())
+	{
+		StateManager->UnregisterVehicle(this);
+		StateManager.Reset();
+	}
+
+	/* Stop recording history of this vehicle. */
+	if(UArcadeVehicleLagCompensationSubsystem* pLagCompensation = GetWorld() ? GetWorld()->GetSubsystem<UArcadeVehicleLagCompensationSubsystem>() : nullptr)
+	{
+		pLagCompensation->UnregisterVehicle(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UArcadeVehicleMovementComponentBase::RegisterComponentTickFunctions(bool bRegister)
@@ -105,14 +176,24 @@ void UArcadeVehicleMovementComponentBase::TickComponent(float DeltaTime, enum EL
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	/* Check who controls this vehicle now. */
-	AController* pNewController = IsValid(GetPawnOwner()) ? GetPawnOwner()->GetController() : nullptr;
-	if(pNewController != CurrentController)
-	{
-		CurrentController = pNewController;
+	/* Check who controls this vehicle now. Possession hooks catch most changes, this catches the rest. */
+	RefreshControlRole();
 
-		/* Clear network data. */
-		ClearNetworkData();
+	/* Hand verdicts of the state validation over to the game. */
+	ProcessValidationResults();
+
+	/* Interpolated and distant remote vehicles skip the simulation entirely, and are only placed at the received states. Mode only switches before the physics step. */
+	if(ThisTickFunction == &PrePhysicsTick)
+	{
+		UpdateKinematicProxy();
+	}
+	if(bIsKinematicProxy)
+	{
+		if(ThisTickFunction == &PrePhysicsTick)
+		{
+			ApplyInterpolation();
+		}
+		return;
 	}
 	
 	/* Skip any sort of physics calculations as soon as the physics is disabled. */
@@ -121,18 +202,28 @@ void UArcadeVehicleMovementComponentBase::TickComponent(float DeltaTime, enum EL
 		return;
 	}
 
-	/* Deploy tick accordingly. */
+	/* Deploy tick accordingly. Both halves of the tick are timed, but only the pre-physics one counts as a new tick. */
+	const bool bTimeSimulation = FVehicleNetTelemetry::IsEnabled();
+	const double simulationStartTime = bTimeSimulation ? FPlatformTime::Seconds() : 0.0;
 	if(ThisTickFunction == &PrePhysicsTick)
 	{
 		OnPrePhysicsTick(DeltaTime);
+		if(bTimeSimulation)
+		{
+			NetTelemetry.AddSimulationTime(FPlatformTime::Seconds() - simulationStartTime, true);
+		}
 	}
 	else if(ThisTickFunction == &PostPhysicsTick)
 	{
 		OnPostPhysicsTick(DeltaTime);
+		if(bTimeSimulation)
+		{
+			NetTelemetry.AddSimulationTime(FPlatformTime::Seconds() - simulationStartTime, false);
+		}
 	}
 
 	/* If locally controlled, always mark for camera updates, so we get net relevancy to work properly. */
-	if (GetPawnOwner()->IsLocallyControlled())
+	if (!bIsStandalone && GetPawnOwner()->IsLocallyControlled())
 	{
 		MarkForClientCameraUpdate();
 	}
@@ -210,8 +301,11 @@ void UArcadeVehicleMovementComponentBase::ApplyVehicleSettings()
 	/* Deinitialize it. */
 	bIsVehicleInitialized = false;
 
-	/* Initialize state buffer. */
-	StateBuffer = FVehiclePhysicsStateArray(100);
+	/* Initialize state buffer. Offline vehicles never receive states, so they don't need it. */
+	if(!bIsStandalone)
+	{
+		StateBuffer = FVehiclePhysicsStateArray(100);
+	}
 	
 	/* Temporarily disable ticking. */
 	SetComponentTickEnabled(false);
@@ -221,6 +315,22 @@ void UArcadeVehicleMovementComponentBase::ApplyVehicleSettings()
 	{
 		bIsVehicleInitialized = RegisterSuspensionSprings();
 	}
+
+	/* Bake engine limits for the state validation, so the validation jobs never touch the curves. */
+	if(ShouldValidateStates())
+	{
+		TSharedPtr<FVehicleValidationLimits, ESPMode::ThreadSafe> limits = MakeShared<FVehicleValidationLimits, ESPMode::ThreadSafe>();
+		limits->Bake(Settings.Engine, Settings.Network.StateValidationTolerance);
+		ValidationLimits = limits;
+		if(!ValidationResults.IsValid())
+		{
+			ValidationResults = MakeShared<FVehicleValidationResultQueue, ESPMode::ThreadSafe>();
+		}
+	}
+	else
+	{
+		ValidationLimits.Reset();
+	}
 	
 	/* Re-enable ticking. It will automatically keep it false if the vehicle is not initialized properly. */
 	SetComponentTickEnabled(true);
@@ -305,7 +415,14 @@ float UArcadeVehicleMovementComponentBase::GetLastAppliedBraking() const
 
 void UArcadeVehicleMovementComponentBase::SetMaxSpeedMultiplier(const float NewMaxSpeedMultiplier)
 {
+	/* Dormant vehicle would not replicate the new value. */
+	if(MaxSpeedMultiplier != NewMaxSpeedMultiplier)
+	{
+		WakeFromNetDormancy();
+	}
+
 	MaxSpeedMultiplier = NewMaxSpeedMultiplier;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UArcadeVehicleMovementComponentBase, MaxSpeedMultiplier, this);
 }
 
 float UArcadeVehicleMovementComponentBase::GetMaxSpeedMultiplier() const
@@ -397,6 +514,33 @@ void UArcadeVehicleMovementComponentBase::TeleportVehicle(const FTransform& Tran
 	}
 }
 
+void UArcadeVehicleMovementComponentBase::TeleportVehicles(const TArray<UArcadeVehicleMovementComponentBase*>& Vehicles, const TArray<FTransform>& Transforms, float Delay /*= 0.2f*/)
+{
+	if(Vehicles.Num() != Transforms.Num())
+	{
+		UE_LOG(LogArcadeVehicleMovement, Error, TEXT("TeleportVehicles method requires single transform per vehicle!"));
+		return;
+	}
+	if(Vehicles.Num() == 0 || !IsValid(Vehicles[0]))
+	{
+		return;
+	}
+
+	UWorld* pWorld = Vehicles[0]->GetWorld();
+	if(pWorld->GetNetMode() == NM_Client)
+	{
+		UE_LOG(LogArcadeVehicleMovement, Error, TEXT("TeleportVehicles method can only be called on server!"));
+		return;
+	}
+
+	/* Placement is sent through the state manager, which is relevant to everyone. */
+	AArcadeVehicleStateManager* pStateManager = AArcadeVehicleStateManager::Get(pWorld);
+	if(IsValid(pStateManager))
+	{
+		pStateManager->PlaceVehicles(Vehicles, Transforms, Delay);
+	}
+}
+
 void UArcadeVehicleMovementComponentBase::SetVehicleLinearVelocity(const FVector& LinearVelocity, const bool WorldSpace /*= false*/)
 {
 	/* Handle world space. */
@@ -429,14 +573,15 @@ bool UArcadeVehicleMovementComponentBase::IsAccelerationBlocked() const
 
 void UArcadeVehicleMovementComponentBase::SetBlockAcceleration(bool Block)
 {
-	/* Only allowed on the client that owns vehicle. */
-	if(HasControlOverVehicle())
+	/* Only allowed on the client that owns vehicle, or on the server when it is authoritative. */
+	const bool bCanModify = IsServerAuthoritative() ? GetOwnerRole() == ROLE_Authority : HasControlOverVehicle();
+	if(bCanModify)
 	{
 		PhysicsRuntime.SetMovementModifier(AVS_MM_BlockAcceleration, Block);
 	}
 	else
 	{
-		UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("SetBlockAcceleration can only be called on the client that controls this vehicle!"));
+		UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("SetBlockAcceleration can only be called on the server with server authority, or on the client that controls this vehicle otherwise!"));
 	}
 }
 
@@ -450,11 +595,19 @@ void UArcadeVehicleMovementComponentBase::ClearNetworkData()
 	/* Clear physics state and inputs. */
 	ClearInputs();
 	StateBuffer.Clear();
+	JitterBuffer.Clear();
+	RemoteInputTimeline.Clear();
+	InputStepAccumulator = 0.f;
 	LocationCorrection.Reset();
 	RotationCorrection.Reset();
 	LinearVelocityCorrection.Reset();
 	AngularVelocityCorrection.Reset();
 	PhysicsRuntime.bHasLastTotalFriction = false;
+	bHasReceivedState = false;
+	PredictionHistory.Clear();
+
+	/* Make sure the next state sent is a full keyframe. */
+	LastKeyframeTime = TNumericLimits<double>::Lowest();
 }
 
 void UArcadeVehicleMovementComponentBase::ClearInputs()
@@ -477,14 +630,91 @@ const UArcadeVehiclePathFollowingComponent* UArcadeVehicleMovementComponentBase:
 
 bool UArcadeVehicleMovementComponentBase::HasControlOverVehicle() const
 {
-	return (GetPawnOwner()->IsPawnControlled() && GetPawnOwner()->IsLocallyControlled()) || (!GetPawnOwner()->IsPawnControlled() && GetPawnOwner()->HasAuthority());
+	return bIsStandalone || bHasControlOverVehicle;
+}
+
+bool UArcadeVehicleMovementComponentBase::IsStandalone() const
+{
+	return bIsStandalone;
+}
+
+void UArcadeVehicleMovementComponentBase::UpdateControlRole()
+{
+	const APawn* pPawn = GetPawnOwner();
+	bHasControlOverVehicle = IsValid(pPawn) && ((pPawn->IsPawnControlled() && pPawn->IsLocallyControlled()) || (!pPawn->IsPawnControlled() && pPawn->HasAuthority()));
+}
+
+void UArcadeVehicleMovementComponentBase::RefreshControlRole()
+{
+	AController* pNewController = IsValid(GetPawnOwner()) ? GetPawnOwner()->GetController() : nullptr;
+	if(pNewController != CurrentController)
+	{
+		CurrentController = pNewController;
+		UpdateControlRole();
+
+		/* Clear network data. */
+		ClearNetworkData();
+	}
+}
+
+void UArcadeVehicleMovementComponentBase::OnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+	RefreshControlRole();
+}
+
+const FVehiclePhysicsState& UArcadeVehicleMovementComponentBase::GetReplicatedState() const
+{
+	return ServerState;
+}
+
+void UArcadeVehicleMovementComponentBase::ReceiveBatchedState(const FVehiclePhysicsState& State)
+{
+	/* Batched states are sent to everyone, so skip owner here, the same way regular replication does. */
+	if(!IsBatchingStates() || HasControlOverVehicle())
+	{
+		return;
+	}
+
+	ServerState = State;
+	OnRep_ServerState();
+}
+
+const FVehicleNetTelemetry& UArcadeVehicleMovementComponentBase::GetNetTelemetry() const
+{
+	return NetTelemetry;
+}
+
+void UArcadeVehicleMovementComponentBase::ResetNetTelemetry()
+{
+	NetTelemetry.Reset();
+}
+
+void UArcadeVehicleMovementComponentBase::WakeFromNetDormancy()
+{
+	/* Restart counting the time of the stable state. */
+	DormancyReferenceTime = TNumericLimits<double>::Lowest();
+
+	if(IsNetDormant() && GetOwnerRole() == ROLE_Authority)
+	{
+		GetOwner()->SetNetDormancy(DORM_Awake);
+	}
+}
+
+bool UArcadeVehicleMovementComponentBase::IsNetDormant() const
+{
+	return GetOwner()->NetDormancy > DORM_Awake;
+}
+
+bool UArcadeVehicleMovementComponentBase::IsKinematicProxy() const
+{
+	return bIsKinematicProxy;
 }
 
 void UArcadeVehicleMovementComponentBase::OnPrePhysicsTick(float DeltaTime)
 {
 	/* Multiply delta time to match simulation speeds of the previous movement curves etc. */
 	const float regularDeltaTime = DeltaTime;
-	DeltaTime *= 8.f;
+	DeltaTime *= ForcesTimeScale;
 
 	/* Prepare simulation frame. */
 	PrepareFrame();
@@ -498,6 +728,21 @@ void UArcadeVehicleMovementComponentBase::OnPrePhysicsTick(float DeltaTime)
 		CalculateSuspension(regularDeltaTime);
 	}
 
+	/* Local-space velocities that will be modulated by the acceleration and turning forces. Start from current ones. */
+	FVector linearVelocity = PhysicsRuntime.LocalLinearVelocity;
+	FVector angularVelocity = PhysicsPrimitive->GetComponentTransform().InverseTransformVectorNoScale(PhysicsRuntime.AngularVelocity);
+	CalculateVelocities(PhysicsPrimitive->GetComponentRotation(), DeltaTime, linearVelocity, angularVelocity);
+
+	/* Transform final velocities from local to world and apply them. */
+	PhysicsPrimitive->SetPhysicsLinearVelocity(PhysicsPrimitive->GetComponentTransform().TransformVectorNoScale(linearVelocity));
+	PhysicsPrimitive->SetPhysicsAngularVelocityInDegrees(PhysicsPrimitive->GetComponentTransform().TransformVectorNoScale(angularVelocity));
+
+	/* Apply custom movement */
+	CalculateCustomVehicleMovement.Broadcast(PhysicsPrimitive, CurrentInput, DeltaTime);
+}
+
+void UArcadeVehicleMovementComponentBase::CalculateVelocities(const FRotator& Rotation, float DeltaTime, FVector& InOutLinearVelocity, FVector& InOutAngularVelocity)
+{
 	/* Calculate adherence. */
 	float linearAdherence, angularAdherence;
 	if(Settings.Advanced.bEnableAdherence)
@@ -510,77 +755,126 @@ void UArcadeVehicleMovementComponentBase::OnPrePhysicsTick(float DeltaTime)
 		angularAdherence = Settings.Steering.AngularDamping;
 	}
 
-	/* Local-space linear velocity that will be modulated by the acceleration forces. Starts from current one. */
-	FVector linearVelocity = PhysicsRuntime.LocalLinearVelocity;
-	
 	/* Calculate acceleration if some drive wheels touch the ground. */
 	if(WheelsInfo.DriveWheelsOnGround > 0)
 	{
 		if(Settings.Advanced.bEnableAcceleration)
 		{
-			linearVelocity = CalculateAcceleration(DeltaTime, linearAdherence);
+			InOutLinearVelocity = CalculateAcceleration(DeltaTime, linearAdherence);
 		}
 	}
 
-	/* Angular velocity that will be modulated by the turning forces. Start from current one. */
-	FVector angularVelocity = PhysicsPrimitive->GetComponentTransform().InverseTransformVectorNoScale(PhysicsRuntime.AngularVelocity);
-
 	/* Calculate steering if some steering wheels are on ground. */
 	if(WheelsInfo.SteeringWheelsOnGround > 0)
 	{
 		if(Settings.Advanced.bEnableAdherence)
 		{
-			angularVelocity = CalcuateAngularAdherence(DeltaTime, angularAdherence, angularVelocity);
+			InOutAngularVelocity = CalcuateAngularAdherence(DeltaTime, angularAdherence, InOutAngularVelocity);
 		}
 		if(Settings.Advanced.bEnableTurning)
 		{
-			CalculateTurning(DeltaTime, angularVelocity);
+			CalculateTurning(DeltaTime, InOutAngularVelocity);
 		}
 	}
 
 	/* Calculate friction forces. */
 	if(Settings.Advanced.bEnableFriction)
 	{
-		CalculateFriction(DeltaTime, linearVelocity);
+		CalculateFriction(DeltaTime, InOutLinearVelocity);
 	}
 
-	/* Transform final linear velocity from local to world. */
-	linearVelocity = PhysicsPrimitive->GetComponentTransform().TransformVectorNoScale(linearVelocity);
-
-	/* Apply this frame linear velocity if at least one drive wheel is on ground. */
-	PhysicsPrimitive->SetPhysicsLinearVelocity(linearVelocity);
-
 	/* Apply stabilization if needed. */
 	if (CurrentInput.IsStabilizing())
 	{
-		angularVelocity.X = PhysicsPrimitive->GetComponentRotation().Roll * Settings.Physics.StabilizationForce * DeltaTime;
-		angularVelocity.Y = PhysicsPrimitive->GetComponentRotation().Pitch * Settings.Physics.StabilizationForce * DeltaTime;
+		InOutAngularVelocity.X = Rotation.Roll * Settings.Physics.StabilizationForce * DeltaTime;
+		InOutAngularVelocity.Y = Rotation.Pitch * Settings.Physics.StabilizationForce * DeltaTime;
 	}
-	
-	/* Apply this frame angular velocity. */
-	angularVelocity = PhysicsPrimitive->GetComponentTransform().TransformVectorNoScale(angularVelocity);
-	PhysicsPrimitive->SetPhysicsAngularVelocityInDegrees(angularVelocity);
-
-	/* Apply custom movement */
-	CalculateCustomVehicleMovement.Broadcast(PhysicsPrimitive, CurrentInput, DeltaTime);
 }
 
 void UArcadeVehicleMovementComponentBase::OnPostPhysicsTick(float DeltaTime)
 {
+	/* Offline session has nobody to send the state to, nor anybody to receive it from. */
+	if(bIsStandalone)
+	{
+		return;
+	}
+
 	/* Fully build state based on current physics information. */
-	const FVehiclePhysicsState physicsState = BuildState();
+	FVehiclePhysicsState physicsState = BuildState();
 
 	/* If we are owner of this vehicle. */
 	if(HasControlOverVehicle())
 	{
-		/* Send state to the server. */
-		OnReceiveState_Server(physicsState);
+		/* Record input once per input step, so it is sent again with the next packets in case this one is lost. Server authority needs at least its sequence. */
+		const int32 inputSteps = UsesInputHistory() ? AdvanceInputSteps(DeltaTime) : 0;
+		for(int32 step = 0; step < inputSteps; ++step)
+		{
+			LocalInputHistory.AddInput(CurrentInput, Settings.Network.InputHistorySize);
+		}
+
+		/* Owning client of server authoritative vehicle remembers what it has predicted with this input, so it can roll back to it. */
+		const bool bIsPredicting = IsServerAuthoritative() && GetOwnerRole() != ROLE_Authority;
+		if(bIsPredicting)
+		{
+			RecordPredictionFrames(physicsState, inputSteps);
+		}
+
+		/* Check if the vehicle has come to rest, so it can go net dormant. */
+		const bool bGoingDormant = UpdateNetDormancy(physicsState);
+
+		/* Only skip sending when the dormancy is ours, owners of vehicles dormant for other reasons still need to send their states. */
+		if(CanBecomeNetDormant() && IsNetDormant())
+		{
+			return;
+		}
+
+		/* Input history goes with every packet. */
+		if(UsesInputHistory())
+		{
+			NetTelemetry.AddBytesSent(FVehicleNetTelemetry::GetSerializedBytes(LocalInputHistory));
+		}
+
+		/* Send full state to the server if it's time for the keyframe. Final keyframe settles clients exactly before the vehicle goes dormant. */
+		if(bGoingDormant)
+		{
+			physicsState.LinearVelocity = FVector::ZeroVector;
+			physicsState.AngularVelocity = FVector::ZeroVector;
+		}
+		if(bGoingDormant || (ShouldSendKeyframe() && !bIsPredicting))
+		{
+			LastKeyframeTime = GetWorld()->GetTimeSeconds();
+			physicsState.TimeStamp = GetOutgoingTimeStamp(physicsState.TimeStamp);
+			OnReceiveState_Server(physicsState, LocalInputHistory);
+			NetTelemetry.AddBytesSent(FVehicleNetTelemetry::GetSerializedBytes(physicsState));
+		}
+		/* Otherwise only send the inputs. */
+		else
+		{
+			FVehicleInputFrame inputFrame = BuildInputFrame();
+			inputFrame.TimeStamp = GetOutgoingTimeStamp(inputFrame.TimeStamp);
+			OnReceiveInput_Server(inputFrame, LocalInputHistory);
+			NetTelemetry.AddBytesSent(FVehicleNetTelemetry::GetSerializedBytes(inputFrame));
+		}
+
+		/* Actor channel replicates the final keyframe before it closes for dormancy. */
+		if(bGoingDormant)
+		{
+			GetOwner()->ForceNetUpdate();
+			GetOwner()->SetNetDormancy(DORM_DormantAll);
+		}
 	}
 	/* If we do not control this vehicle. */
 	else
 	{
+		/* With server authority, state the server has simulated from the inputs is the one everyone follows. */
+		if(IsServerAuthoritative() && GetOwnerRole() == ROLE_Authority)
+		{
+			PublishAuthoritativeState(physicsState);
+		}
+
 		/* Add state to the buffer. */
 		StateBuffer.AddState(physicsState);
+		NetTelemetry.AddBufferSample(StateBuffer.Num());
 	}
 }
 
@@ -589,11 +883,21 @@ void UArcadeVehicleMovementComponentBase::PrepareFrame()
 	/* If we have no control over this vehicle. */
 	if(!HasControlOverVehicle())
 	{
-		/* Apply physics corrections if any. */
-		ApplyPhysicsCorrections();
+		/* Either render the vehicle from the jitter buffer, or apply physics corrections if any. */
+		if(UsesInterpolation())
+		{
+			ApplyInterpolation();
+		}
+		else
+		{
+			ApplyPhysicsCorrections();
+		}
 
-		/* Apply movement modifiers. */
-		PhysicsRuntime.MovementModifiers = ServerState.GetMovementModifiers();
+		/* Apply movement modifiers, unless the server owns them. */
+		if(!IsServerAuthoritative() || GetOwnerRole() != ROLE_Authority)
+		{
+			PhysicsRuntime.MovementModifiers = RemoteMovementModifiers;
+		}
 	}
 	
 	/* Gather inputs. */
@@ -611,14 +915,36 @@ void UArcadeVehicleMovementComponentBase::GatherInputs()
 	/* If we are controlling this vehicle. */
 	if(HasControlOverVehicle())
 	{
-		/* Current input is our local input. */
+		/* Current input is our local input. Quantized, so everyone simulates exactly what they receive. Offline there is no one else, so it keeps full precision. */
 		CurrentInput = LocalInput;
+		if(Settings.Network.bQuantizeInputsLocally && !bIsStandalone)
+		{
+			CurrentInput.Quantize();
+		}
 	}
 	/* If we don't have any control over vehicle. */
 	else
 	{
-		/* Current input comes from oldest state we will be dispatching. */
-		CurrentInput = ServerState.Input;
+		/* Current input comes from the input timeline if there is any pending input, otherwise from the latest state or input frame we have received. */
+		/* Timeline inputs are consumed at the rate they were recorded at. Backlog beyond the max pending inputs is consumed right away, so it doesn't build up latency. */
+		const int32 inputSteps = AdvanceInputSteps(GetWorld()->GetDeltaSeconds());
+		const int32 inputsToPull = inputSteps + FMath::Max(0, RemoteInputTimeline.Num() - inputSteps - FVehicleInputTimeline::MaxPendingInputs);
+		int32 pulledInputs = 0;
+		while(pulledInputs < inputsToPull && RemoteInputTimeline.PullInput(RemoteInput))
+		{
+			SimulatedInputSequence = RemoteInputTimeline.GetPulledSequence();
+			++pulledInputs;
+		}
+		bHasNewInputSequence = pulledInputs > 0;
+		CurrentInput = RemoteInput;
+
+		/* Backlog skipped to catch up is never simulated, so it counts as dropped. */
+		const int32 skippedInputs = pulledInputs - inputSteps;
+		if(skippedInputs > 0)
+		{
+			NetTelemetry.AddDroppedInputs(skippedInputs);
+			UE_LOG(LogArcadeVehicleMovement, Verbose, TEXT("%s: skipped %d remote inputs to catch up with the input backlog."), *GetNameSafe(GetOwner()), skippedInputs);
+		}
 	}
 }
 
@@ -749,6 +1075,11 @@ bool UArcadeVehicleMovementComponentBase::RegisterSuspensionSprings()
 }
 
 void UArcadeVehicleMovementComponentBase::CalculatePhysicsRuntimeData()
+{
+	UpdatePhysicsRuntime(PhysicsPrimitive->GetComponentQuat(), PhysicsPrimitive->GetPhysicsLinearVelocity(), PhysicsPrimitive->GetPhysicsAngularVelocityInDegrees());
+}
+
+void UArcadeVehicleMovementComponentBase::UpdatePhysicsRuntime(const FQuat& Rotation, const FVector& LinearVelocity, const FVector& AngularVelocity)
 {
 	/* Resets runtime flags. */
 	PhysicsRuntime.bIsBraking = false;
@@ -756,10 +1087,10 @@ void UArcadeVehicleMovementComponentBase::CalculatePhysicsRuntimeData()
 	PhysicsRuntime.bIsAccelerating = false;
 	
 	/* Calculate global value of the local linear velocity of this vehicle. */
-	PhysicsRuntime.LocalLinearVelocity = PhysicsPrimitive->GetComponentTransform().InverseTransformVectorNoScale(PhysicsPrimitive->GetPhysicsLinearVelocity());
+	PhysicsRuntime.LocalLinearVelocity = Rotation.UnrotateVector(LinearVelocity);
 
 	/* Calculate global value of the angular velocity of this vehicle. */
-	PhysicsRuntime.AngularVelocity = PhysicsPrimitive->GetPhysicsAngularVelocityInDegrees();
+	PhysicsRuntime.AngularVelocity = AngularVelocity;
 
 	/* Calculate current speed in km/h. 0.036f is multiplied because of m/s conversion. */
 	PhysicsRuntime.CurrentSpeed = PhysicsRuntime.LocalLinearVelocity.X * KMH_MULTIPLIER;
@@ -1112,6 +1443,12 @@ void UArcadeVehicleMovementComponentBase::CalculateFriction(float DeltaTime, FVe
 	const float latestSped = FMath::Abs(LinearVelocity.X * KMH_MULTIPLIER);
 	const bool bApplyTotalFriction = Settings.Physics.TotalFrictionSpeedThreshold > 0.f && frictionForceAlpha > 0.f && latestSped <= Settings.Physics.TotalFrictionSpeedThreshold;
 
+	/* Total friction snaps the body itself, which is left alone while re-simulating. */
+	if (bIsResimulating)
+	{
+		return;
+	}
+
 	/* Check should apply total friction this frame. */
 	if (bApplyTotalFriction)
 	{
@@ -1184,13 +1521,68 @@ void UArcadeVehicleMovementComponentBase::CalculateTurning(float DeltaTime, FVec
 	InOutAngularVelocity.Z += frameDeltaRotation;
 }
 
-void UArcadeVehicleMovementComponentBase::OnReceiveState_Server_Implementation(const FVehiclePhysicsState& State)
+void UArcadeVehicleMovementComponentBase::OnReceiveState_Server_Implementation(const FVehiclePhysicsState& State, const FVehicleInputHistory& History)
 {
+	/* Replicate input history to everyone and recover inputs of lost packets. */
+	if(History.Inputs.Num() > 0)
+	{
+		ServerInputHistory = History;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UArcadeVehicleMovementComponentBase, ServerInputHistory, this);
+		ReceiveInputHistory(History);
+	}
+
+	/* With server authority, states of the owning client are never trusted, server simulates its inputs instead. */
+	if(IsServerAuthoritative() && !HasControlOverVehicle())
+	{
+		return;
+	}
+
 	/* Set this most up to date server state in order to replicate it to everyone. */
 	ServerState = State;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UArcadeVehicleMovementComponentBase, ServerState, this);
+	if(!HasControlOverVehicle())
+	{
+		NetTelemetry.AddBytesReceived(FVehicleNetTelemetry::GetSerializedBytes(State));
+	}
+
+	/* Check plausibility of the state off the game thread. */
+	if(!HasControlOverVehicle() && ValidationLimits.IsValid())
+	{
+		ValidateState(State, History);
+	}
 
 	/* Calculate server state timestamp. We need to grab current server time, and remove half RTT from it, so we know when client has completed this state. */
-	ServerState.TimeStamp = GetHalfRTT();
+	/* Synchronized time stamps already contain server time of the state. */
+	if(!Settings.Network.bUseSynchronizedTime)
+	{
+		ServerState.TimeStamp = GetHalfRTT();
+	}
+
+	/* Hand the state over to the state manager if it is batched. */
+	if(IsBatchingStates())
+	{
+		if(!StateManager.IsValid())
+		{
+			StateManager = AArcadeVehicleStateManager::Get(GetWorld());
+		}
+		if(StateManager.IsValid())
+		{
+			StateManager->UpdateVehicleState(this, ServerState);
+		}
+	}
+
+	/* With input stream, keyframe input is the latest input as well. */
+	if(Settings.Network.ReplicationMode == VehicleReplicationMode::InputStream)
+	{
+		ServerInput.TimeStamp = ServerState.TimeStamp;
+		ServerInput.Input = ServerState.Input;
+		ServerInput.MovementModifiers = ServerState.GetMovementModifiers();
+		MARK_PROPERTY_DIRTY_FROM_NAME(UArcadeVehicleMovementComponentBase, ServerInput, this);
+		if(!HasControlOverVehicle())
+		{
+			OnRep_ServerInput();
+		}
+	}
 	
 	/* If server receiving here is also in control of this vehicle, he doesn't want to buffer anything. */
 	if(!HasControlOverVehicle())
@@ -1200,12 +1592,57 @@ void UArcadeVehicleMovementComponentBase::OnReceiveState_Server_Implementation(c
 	}
 }
 
+void UArcadeVehicleMovementComponentBase::OnReceiveInput_Server_Implementation(const FVehicleInputFrame& Frame, const FVehicleInputHistory& History)
+{
+	/* Replicate input history to everyone and recover inputs of lost packets. */
+	if(History.Inputs.Num() > 0)
+	{
+		ServerInputHistory = History;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UArcadeVehicleMovementComponentBase, ServerInputHistory, this);
+		ReceiveInputHistory(History);
+	}
+
+	/* Set this most up to date input frame in order to replicate it to everyone. */
+	ServerInput = Frame;
+
+	/* With server authority, only inputs are taken from the client. Movement modifiers belong to the server. */
+	if(IsServerAuthoritative())
+	{
+		ServerInput.MovementModifiers = PhysicsRuntime.MovementModifiers;
+	}
+	MARK_PROPERTY_DIRTY_FROM_NAME(UArcadeVehicleMovementComponentBase, ServerInput, this);
+	if(!HasControlOverVehicle())
+	{
+		NetTelemetry.AddBytesReceived(FVehicleNetTelemetry::GetSerializedBytes(Frame));
+	}
+
+	/* Input frame timestamp follows the same rules as the state timestamp. */
+	if(!Settings.Network.bUseSynchronizedTime)
+	{
+		ServerInput.TimeStamp = GetHalfRTT();
+	}
+
+	/* If server receiving here is also in control of this vehicle, he doesn't need the input. */
+	if(!HasControlOverVehicle())
+	{
+		OnRep_ServerInput();
+	}
+}
+
 void UArcadeVehicleMovementComponentBase::OnReceiveTeleport_Server_Implementation(const FVector_NetQuantize& Location, const FRotator& Rotation)
 {
+	/* Multicast won't reach clients while the vehicle is dormant. */
+	WakeFromNetDormancy();
+
 	OnReceiveTeleport_Client(Location, Rotation);
 }
 
 void UArcadeVehicleMovementComponentBase::OnReceiveTeleport_Client_Implementation(const FVector_NetQuantize& Location, const FRotator& Rotation)
+{
+	ApplyTeleport(Location, Rotation);
+}
+
+void UArcadeVehicleMovementComponentBase::ApplyTeleport(const FVector& Location, const FRotator& Rotation)
 {
 	/* Cache last teleport time. */
 	LastTeleportTime = GetWorld()->GetTimeSeconds();
@@ -1227,8 +1664,30 @@ void UArcadeVehicleMovementComponentBase::GetLifetimeReplicatedProps(TArray<FLif
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME_CONDITION(UArcadeVehicleMovementComponentBase, ServerState, COND_SkipOwner);
-	DOREPLIFETIME(UArcadeVehicleMovementComponentBase, MaxSpeedMultiplier);
+	/* Properties are push based, so they are only compared when marked dirty by the server. */
+	FDoRepLifetimeParams skipOwnerParams;
+	skipOwnerParams.Condition = COND_SkipOwner;
+	skipOwnerParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UArcadeVehicleMovementComponentBase, ServerState, skipOwnerParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UArcadeVehicleMovementComponentBase, ServerInput, skipOwnerParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UArcadeVehicleMovementComponentBase, ServerInputHistory, skipOwnerParams);
+
+	FDoRepLifetimeParams ownerOnlyParams;
+	ownerOnlyParams.Condition = COND_OwnerOnly;
+	ownerOnlyParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UArcadeVehicleMovementComponentBase, AuthoritativeState, ownerOnlyParams);
+
+	FDoRepLifetimeParams params;
+	params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UArcadeVehicleMovementComponentBase, MaxSpeedMultiplier, params);
+}
+
+void UArcadeVehicleMovementComponentBase::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	/* Batched server state is replicated by the state manager instead. */
+	DOREPLIFETIME_ACTIVE_OVERRIDE_FAST(UArcadeVehicleMovementComponentBase, ServerState, !IsBatchingStates());
 }
 
 FVehiclePhysicsState UArcadeVehicleMovementComponentBase::BuildState() const
@@ -1244,6 +1703,227 @@ FVehiclePhysicsState UArcadeVehicleMovementComponentBase::BuildState() const
 	return outputState;
 }
 
+FVehicleInputFrame UArcadeVehicleMovementComponentBase::BuildInputFrame() const
+{
+	FVehicleInputFrame outputFrame;
+	outputFrame.Input = CurrentInput;
+	outputFrame.MovementModifiers = PhysicsRuntime.MovementModifiers;
+	outputFrame.TimeStamp = GetWorld()->GetTimeSeconds();
+	return outputFrame;
+}
+
+bool UArcadeVehicleMovementComponentBase::ShouldSendKeyframe() const
+{
+	/* Full state mode sends keyframe every frame. */
+	if(Settings.Network.ReplicationMode == VehicleReplicationMode::FullState)
+	{
+		return true;
+	}
+
+	/* Input stream mode sends keyframe only when the interval has passed. */
+	return GetWorld()->GetTimeSeconds() - LastKeyframeTime >= Settings.Network.KeyframeInterval * 0.001f;
+}
+
+bool UArcadeVehicleMovementComponentBase::IsBatchingStates() const
+{
+	/* State manager is relevant to everyone, which would bypass relevancy and frequency the replication graph assigns to the vehicles. */
+	if(!Settings.Network.bBatchStateReplication)
+	{
+		return false;
+	}
+
+	const UNetDriver* pNetDriver = GetWorld()->GetNetDriver();
+	return !IsValid(pNetDriver) || pNetDriver->GetReplicationDriver() == nullptr;
+}
+
+bool UArcadeVehicleMovementComponentBase::IsServerAuthoritative() const
+{
+	return Settings.Network.bServerAuthoritative && !bIsStandalone;
+}
+
+void UArcadeVehicleMovementComponentBase::PublishAuthoritativeState(const FVehiclePhysicsState& State)
+{
+	/* Synchronized time expects server time, which the state already has. Otherwise the state has been calculated just now. */
+	FVehiclePhysicsState authoritativeState = State;
+	if(!Settings.Network.bUseSynchronizedTime)
+	{
+		authoritativeState.TimeStamp = 0.0;
+	}
+
+	/* Everyone else follows the server state the same way as in the client authoritative mode. */
+	ServerState = authoritativeState;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UArcadeVehicleMovementComponentBase, ServerState, this);
+	if(IsBatchingStates())
+	{
+		if(!StateManager.IsValid())
+		{
+			StateManager = AArcadeVehicleStateManager::Get(GetWorld());
+		}
+		if(StateManager.IsValid())
+		{
+			StateManager->UpdateVehicleState(this, ServerState);
+		}
+	}
+
+	/* Owning client compares it with the frame it has predicted with the same input, so it is only sent for newly consumed input. */
+	if(!bHasNewInputSequence)
+	{
+		return;
+	}
+
+	/* Predicted frames end at their input step, so the state is moved back by the time the step clock is past it. */
+	AuthoritativeState.State = ExtrapolateState(authoritativeState, -InputStepAccumulator);
+	AuthoritativeState.Sequence = SimulatedInputSequence;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UArcadeVehicleMovementComponentBase, AuthoritativeState, this);
+}
+
+void UArcadeVehicleMovementComponentBase::RecordPredictionFrames(const FVehiclePhysicsState& State, int32 InputSteps)
+{
+	/* All of the steps completed this frame share the state of the frame, moved back to the end of each step. */
+	const float stepTime = GetInputStepTime();
+	for(int32 step = 0; step < InputSteps; ++step)
+	{
+		const int32 stepsAhead = InputSteps - 1 - step;
+		FVehiclePredictionFrame frame;
+		frame.Sequence = static_cast<uint16>(LocalInputHistory.Sequence - stepsAhead);
+		frame.DeltaTime = stepTime;
+		frame.State = ExtrapolateState(State, -(InputStepAccumulator + stepsAhead * stepTime));
+		frame.Input = CurrentInput;
+		frame.Forces = LastForces;
+		frame.AdherenceMultiplier = PhysicsRuntime.AdherenceMultiplier;
+		frame.RotationMultiplier = PhysicsRuntime.RotationMultiplier;
+		frame.MovementModifiers = PhysicsRuntime.MovementModifiers;
+		frame.DriveWheelsOnGround = WheelsInfo.DriveWheelsOnGround;
+		frame.SteeringWheelsOnGround = WheelsInfo.SteeringWheelsOnGround;
+		PredictionHistory.AddFrame(frame);
+	}
+}
+
+void UArcadeVehicleMovementComponentBase::SimulateKinematicStep(const FVehiclePredictionFrame& Previous, FVehiclePredictionFrame& Frame)
+{
+	/* Continue from what the previous step has ended with, using input and ground contact this step was predicted with. */
+	CurrentInput = Frame.Input;
+	LastForces = Previous.Forces;
+	PhysicsRuntime.AdherenceMultiplier = Previous.AdherenceMultiplier;
+	PhysicsRuntime.RotationMultiplier = Previous.RotationMultiplier;
+	PhysicsRuntime.MovementModifiers = Frame.MovementModifiers;
+	WheelsInfo.DriveWheelsOnGround = Frame.DriveWheelsOnGround;
+	WheelsInfo.SteeringWheelsOnGround = Frame.SteeringWheelsOnGround;
+
+	/* Same arcade step as the simulation, only on the state instead of the physics body. */
+	const FVehiclePhysicsState& previousState = Previous.State;
+	const FQuat previousRotation = previousState.Rotation.Quaternion();
+	UpdatePhysicsRuntime(previousRotation, previousState.LinearVelocity, previousState.AngularVelocity);
+	CalculateForces();
+	FVector linearVelocity = PhysicsRuntime.LocalLinearVelocity;
+	FVector angularVelocity = previousRotation.UnrotateVector(previousState.AngularVelocity);
+	CalculateVelocities(previousState.Rotation, Frame.DeltaTime * ForcesTimeScale, linearVelocity, angularVelocity);
+
+	/* Vertical velocity, roll and pitch come from gravity, suspension and contacts, which only the physics engine steps. They are taken from the prediction. */
+	const FQuat predictedRotation = Frame.State.Rotation.Quaternion();
+	const FVector predictedLinearVelocity = predictedRotation.UnrotateVector(Frame.State.LinearVelocity);
+	const FVector predictedAngularVelocity = predictedRotation.UnrotateVector(Frame.State.AngularVelocity);
+	linearVelocity.Z = predictedLinearVelocity.Z;
+	angularVelocity.X = predictedAngularVelocity.X;
+	angularVelocity.Y = predictedAngularVelocity.Y;
+
+	/* Integrate the step the same way the physics engine does, velocities first. */
+	Frame.State.LinearVelocity = previousRotation.RotateVector(linearVelocity);
+	Frame.State.AngularVelocity = previousRotation.RotateVector(angularVelocity);
+	Frame.State.Location = previousState.Location + Frame.State.LinearVelocity * Frame.DeltaTime;
+	const FVector rotationVector = FMath::DegreesToRadians(FVector(Frame.State.AngularVelocity)) * Frame.DeltaTime;
+	const float angle = rotationVector.Size();
+	Frame.State.Rotation = (angle > UE_SMALL_NUMBER ? (FQuat(rotationVector / angle, angle) * previousRotation).GetNormalized() : previousRotation).Rotator();
+
+	/* Next step continues from the forces this one has ended with. */
+	Frame.Forces = LastForces;
+	Frame.AdherenceMultiplier = PhysicsRuntime.AdherenceMultiplier;
+	Frame.RotationMultiplier = PhysicsRuntime.RotationMultiplier;
+}
+
+bool UArcadeVehicleMovementComponentBase::CanBecomeNetDormant() const
+{
+	/* Only server controlled vehicles, as remote owners need an open actor channel to send their states. */
+	return Settings.Network.bEnableNetDormancy && GetOwnerRole() == ROLE_Authority && !GetPawnOwner()->IsPlayerControlled();
+}
+
+bool UArcadeVehicleMovementComponentBase::UpdateNetDormancy(const FVehiclePhysicsState& State)
+{
+	if(!CanBecomeNetDormant())
+	{
+		return false;
+	}
+
+	/* State is stable when the vehicle has not moved, rotated or changed its input since the reference time. */
+	const double currentTime = GetWorld()->GetTimeSeconds();
+	const bool bIsStable = DormancyReferenceTime != TNumericLimits<double>::Lowest()
+		&& FVector::Dist(State.Location, DormancyReferenceState.Location) <= 1.f
+		&& AngularDistance(State.Rotation.Quaternion(), DormancyReferenceState.Rotation.Quaternion()) <= 1.f
+		&& State.Input.Equals(DormancyReferenceState.Input)
+		&& State.GetMovementModifiers() == DormancyReferenceState.GetMovementModifiers();
+
+	/* Any change wakes the vehicle up and becomes the new reference. */
+	if(!bIsStable)
+	{
+		WakeFromNetDormancy();
+		DormancyReferenceState = State;
+		DormancyReferenceTime = currentTime;
+		return false;
+	}
+
+	/* Go dormant once the state has been stable for long enough. */
+	return !IsNetDormant() && currentTime - DormancyReferenceTime >= Settings.Network.NetDormancyDelay * 0.001f;
+}
+
+void UArcadeVehicleMovementComponentBase::OnVehicleHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	if(IsNetDormant())
+	{
+		WakeFromNetDormancy();
+	}
+}
+
+bool UArcadeVehicleMovementComponentBase::ShouldValidateStates() const
+{
+	return Settings.Network.bValidateClientStates && GetOwnerRole() == ROLE_Authority && !bIsStandalone;
+}
+
+void UArcadeVehicleMovementComponentBase::ValidateState(const FVehiclePhysicsState& State, const FVehicleInputHistory& History)
+{
+	/* Copy everything the validation needs, it runs on a worker thread. */
+	FVehicleValidationJob job;
+	job.Limits = ValidationLimits;
+	job.PreviousState = LastReceivedState;
+	job.State = State;
+	job.bHasPreviousState = bHasReceivedState;
+	job.Inputs.Append(History.Inputs);
+	job.MaxSpeedMultiplier = MaxSpeedMultiplier;
+	job.Gravity = GetVehicleGravity().Size();
+	ArcadeVehicleStateValidation::LaunchValidation(MoveTemp(job), ValidationResults.ToSharedRef());
+
+	LastReceivedState = State;
+	bHasReceivedState = true;
+}
+
+void UArcadeVehicleMovementComponentBase::ProcessValidationResults()
+{
+	if(!ValidationResults.IsValid())
+	{
+		return;
+	}
+
+	FVehicleValidationResult result;
+	while(ValidationResults->Dequeue(result))
+	{
+		if(result.Verdict != VehicleStateVerdict::Valid)
+		{
+			UE_LOG(LogArcadeVehicleMovement, Verbose, TEXT("%s rejected client state at %.3f: %s"),
+				*GetNameSafe(GetOwner()), result.TimeStamp, *UEnum::GetValueAsString(result.Verdict));
+		}
+		OnStateValidated.Broadcast(result.Verdict, result.TimeStamp);
+	}
+}
+
 void UArcadeVehicleMovementComponentBase::OnRep_ServerState()
 {
 	/* We don't care about states received before we have began play. */
@@ -1252,9 +1932,16 @@ void UArcadeVehicleMovementComponentBase::OnRep_ServerState()
 		return;
 	}
 
-	/* Calculate when this state was originally dispatched. Arriving value contains half RTT of the owner, we will add our half RTT to it. */
+	/* Gather telemetry. Server has already counted the bytes when receiving the state from the owner. */
+	NetTelemetry.AddStateReceived();
+	if(GetOwnerRole() != ROLE_Authority)
+	{
+		NetTelemetry.AddBytesReceived(FVehicleNetTelemetry::GetSerializedBytes(ServerState));
+	}
+
+	/* Calculate when this state was originally dispatched. */
 	const float localHalfRTT = GetHalfRTT();
-	const float localTimeStamp = GetWorld()->GetTimeSeconds() - (ServerState.TimeStamp + localHalfRTT);
+	const double localTimeStamp = GetIncomingLocalTime(ServerState.TimeStamp);
 
 	/* If time stamp is older than last teleport known, do not accept it. */
 	if(localTimeStamp < LastTeleportTime)
@@ -1262,6 +1949,25 @@ void UArcadeVehicleMovementComponentBase::OnRep_ServerState()
 		return;
 	}
 
+	/* With full state replication, remote simulation takes inputs from the state itself, unless they come from the input history. */
+	if(Settings.Network.ReplicationMode == VehicleReplicationMode::FullState)
+	{
+		if(Settings.Network.InputHistorySize == 0)
+		{
+			RemoteInput = ServerState.Input;
+		}
+		RemoteMovementModifiers = ServerState.GetMovementModifiers();
+	}
+
+	/* With interpolation, state only goes to the jitter buffer with its local time stamp. */
+	if(UsesInterpolation())
+	{
+		FVehiclePhysicsState bufferedState = ServerState;
+		bufferedState.TimeStamp = localTimeStamp;
+		JitterBuffer.AddState(bufferedState, GetWorld()->GetTimeSeconds());
+		return;
+	}
+
 	/* Grab the most suitable state we have completed at this time. */
 	FVehiclePhysicsState stateFromPast;
 	if(StateBuffer.GetSuitableState(localTimeStamp, stateFromPast))
@@ -1283,11 +1989,164 @@ void UArcadeVehicleMovementComponentBase::OnRep_ServerState()
 		AngularVelocityCorrection.ErrorValue = ServerState.AngularVelocity - stateFromPast.AngularVelocity;
 		AngularVelocityCorrection.bIsCorrecting = AngularVelocityCorrection.ErrorValue.Size() > 1.f;
 
+		/* Gather telemetry. */
+		NetTelemetry.AddCorrection(LocationCorrection.ErrorValue.Size(), AngularDistance(RotationCorrection.ErrorValue, FQuat::Identity), LinearVelocityCorrection.ErrorValue.Size());
+
 		/* Remove old states from buffer, they won't be of any use. */
 		StateBuffer.ClearOldStates(localTimeStamp + localHalfRTT);
 	}
 }
 
+void UArcadeVehicleMovementComponentBase::OnRep_ServerInput()
+{
+	/* We don't care about inputs received before we have began play. */
+	if (!HasBegunPlay())
+	{
+		return;
+	}
+
+	/* Gather telemetry. */
+	if(GetOwnerRole() != ROLE_Authority)
+	{
+		NetTelemetry.AddBytesReceived(FVehicleNetTelemetry::GetSerializedBytes(ServerInput));
+	}
+
+	/* Calculate when this input was originally used, the same way as for the states. */
+	const double localTimeStamp = GetIncomingLocalTime(ServerInput.TimeStamp);
+
+	/* If time stamp is older than last teleport known, do not accept it. */
+	if(localTimeStamp < LastTeleportTime)
+	{
+		return;
+	}
+
+	/* Remote simulation continues from the last keyframe using this input, unless it comes from the input history. */
+	if(Settings.Network.InputHistorySize == 0)
+	{
+		RemoteInput = ServerInput.Input;
+	}
+	RemoteMovementModifiers = ServerInput.MovementModifiers;
+}
+
+void UArcadeVehicleMovementComponentBase::OnRep_ServerInputHistory()
+{
+	/* We don't care about inputs received before we have began play. */
+	if (!HasBegunPlay())
+	{
+		return;
+	}
+
+	NetTelemetry.AddBytesReceived(FVehicleNetTelemetry::GetSerializedBytes(ServerInputHistory));
+	ReceiveInputHistory(ServerInputHistory);
+}
+
+void UArcadeVehicleMovementComponentBase::OnRep_AuthoritativeState()
+{
+	/* Only the predicting owner cares about the authoritative state. */
+	if(!HasBegunPlay() || !HasControlOverVehicle() || !IsServerAuthoritative())
+	{
+		return;
+	}
+
+	NetTelemetry.AddStateReceived();
+	NetTelemetry.AddBytesReceived(FVehicleNetTelemetry::GetSerializedBytes(AuthoritativeState.State));
+
+	/* Find the frame we have predicted with the same input. If it is gone, the state is too old to be of any use. */
+	const int32 frameIndex = PredictionHistory.FindFrame(AuthoritativeState.Sequence);
+	if(frameIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FVehiclePhysicsState& serverState = AuthoritativeState.State;
+
+	/* Movement modifiers belong to the server, so they are always taken over. */
+	const uint8 serverModifiers = serverState.GetMovementModifiers();
+	PhysicsRuntime.MovementModifiers = serverModifiers;
+
+	const FVehiclePhysicsState& predictedState = PredictionHistory.GetFrame(frameIndex).State;
+	const float locationError = FVector::Dist(serverState.Location, predictedState.Location);
+	const float rotationError = AngularDistance(serverState.Rotation.Quaternion(), predictedState.Rotation.Quaternion());
+	const float linearVelocityError = FVector::Dist(serverState.LinearVelocity, predictedState.LinearVelocity);
+	const float angularVelocityError = FVector::Dist(serverState.AngularVelocity, predictedState.AngularVelocity);
+	NetTelemetry.AddCorrection(locationError, rotationError, linearVelocityError);
+
+	/* If the prediction was right, frames before this one won't be needed anymore. */
+	const float tolerance = Settings.Network.RollbackTolerance;
+	if(locationError <= tolerance && rotationError <= tolerance && linearVelocityError <= tolerance && angularVelocityError <= tolerance)
+	{
+		PredictionHistory.ClearOldFrames(frameIndex);
+		return;
+	}
+
+	/* Rewind to the corrected frame, and re-simulate all of the newer frames right away. Simulation data of the current frame is kept aside meanwhile. */
+	const double resimulationStartTime = FPlatformTime::Seconds();
+	const FVehicleInputState currentInput = CurrentInput;
+	const FVehicleForces lastForces = LastForces;
+	const FVehiclePhysicsRuntime physicsRuntime = PhysicsRuntime;
+	const FVehicleWheelsRuntimeInfo wheelsInfo = WheelsInfo;
+	bIsResimulating = true;
+	const int32 resimulatedFrames = PredictionHistory.Rollback(frameIndex, serverState, [this, serverModifiers](const FVehiclePredictionFrame& Previous, FVehiclePredictionFrame& Frame)
+	{
+		Frame.MovementModifiers = serverModifiers;
+		SimulateKinematicStep(Previous, Frame);
+	});
+	bIsResimulating = false;
+	CurrentInput = currentInput;
+	LastForces = lastForces;
+	PhysicsRuntime = physicsRuntime;
+	WheelsInfo = wheelsInfo;
+
+	/* Newest frame ends at its input step, the vehicle is already past it by the time accumulated towards the next one. */
+	const FVehiclePhysicsState correctedState = ExtrapolateState(PredictionHistory.GetFrame(PredictionHistory.Num() - 1).State, InputStepAccumulator);
+	PhysicsPrimitive->SetWorldLocationAndRotation(correctedState.Location, correctedState.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	PhysicsPrimitive->SetPhysicsLinearVelocity(correctedState.LinearVelocity);
+	PhysicsPrimitive->SetPhysicsAngularVelocityInDegrees(correctedState.AngularVelocity);
+	NetTelemetry.AddRollback(resimulatedFrames, FPlatformTime::Seconds() - resimulationStartTime);
+
+	/* Prevent local friction from pulling the vehicle back to where it was predicted. */
+	if(PhysicsRuntime.bHasLastTotalFriction)
+	{
+		PhysicsRuntime.TotalFrictionSnapLocation = correctedState.Location;
+	}
+}
+
+void UArcadeVehicleMovementComponentBase::ReceiveInputHistory(const FVehicleInputHistory& History)
+{
+	/* Controlling side simulates its own inputs. */
+	if(HasControlOverVehicle())
+	{
+		return;
+	}
+
+	/* Inputs are only dropped when the vehicle doesn't consume them at all, but it should be known. */
+	const int32 droppedInputs = RemoteInputTimeline.Merge(History);
+	if(droppedInputs > 0)
+	{
+		NetTelemetry.AddDroppedInputs(droppedInputs);
+		UE_LOG(LogArcadeVehicleMovement, Verbose, TEXT("%s: dropped %d remote inputs that were not simulated."), *GetNameSafe(GetOwner()), droppedInputs);
+	}
+}
+
+bool UArcadeVehicleMovementComponentBase::UsesInputHistory() const
+{
+	return Settings.Network.InputHistorySize > 0 || IsServerAuthoritative();
+}
+
+float UArcadeVehicleMovementComponentBase::GetInputStepTime() const
+{
+	return 1.f / FMath::Max(Settings.Network.InputStepRate, 1.f);
+}
+
+int32 UArcadeVehicleMovementComponentBase::AdvanceInputSteps(float DeltaTime)
+{
+	const float stepTime = GetInputStepTime();
+	InputStepAccumulator += DeltaTime;
+	const int32 steps = FMath::FloorToInt32(InputStepAccumulator / stepTime);
+	InputStepAccumulator -= steps * stepTime;
+	return steps;
+}
+
 float UArcadeVehicleMovementComponentBase::GetHalfRTT() const
 {
 	if(IsValid(GetPawnOwner()) && IsValid(GetPawnOwner()->GetPlayerState()))
@@ -1298,6 +2157,30 @@ float UArcadeVehicleMovementComponentBase::GetHalfRTT() const
 	return 0.f;
 }
 
+double UArcadeVehicleMovementComponentBase::GetOutgoingTimeStamp(double LocalTime) const
+{
+	/* Without synchronized time, the server stamps the state with half RTT when receiving it. */
+	if(!Settings.Network.bUseSynchronizedTime)
+	{
+		return LocalTime;
+	}
+
+	/* Until the clock is synchronized, server time is estimated using half RTT. */
+	return UArcadeVehicleClockSyncComponent::LocalToServerTime(GetWorld(), LocalTime);
+}
+
+double UArcadeVehicleMovementComponentBase::GetIncomingLocalTime(double TimeStamp) const
+{
+	/* Arriving value contains half RTT of the owner, we will add our half RTT to it. */
+	if(!Settings.Network.bUseSynchronizedTime)
+	{
+		return GetWorld()->GetTimeSeconds() - (TimeStamp + GetHalfRTT());
+	}
+
+	/* Arriving value is server time of the state. */
+	return UArcadeVehicleClockSyncComponent::ServerToLocalTime(GetWorld(), TimeStamp);
+}
+
 void UArcadeVehicleMovementComponentBase::ApplyPhysicsCorrections()
 {
 	/* Cache some values for shorter usage. */
@@ -1311,6 +2194,7 @@ void UArcadeVehicleMovementComponentBase::ApplyPhysicsCorrections()
 		{
 			PhysicsPrimitive->SetWorldLocation(LocationCorrection.ValueOfCorrection, false, nullptr, ETeleportType::TeleportPhysics);
 			LocationCorrection.bIsCorrecting = false;
+			NetTelemetry.AddLocationSnap();
 		}
 		else
 		{
@@ -1337,6 +2221,7 @@ void UArcadeVehicleMovementComponentBase::ApplyPhysicsCorrections()
 		{
 			RotationCorrection.bIsCorrecting = false;
 			PhysicsPrimitive->SetWorldRotation(RotationCorrection.ValueOfCorrection, false, nullptr, ETeleportType::TeleportPhysics);
+			NetTelemetry.AddRotationSnap();
 		}
 		else
 		{
@@ -1371,7 +2256,121 @@ void UArcadeVehicleMovementComponentBase::ApplyPhysicsCorrections()
 	}
 }
 
+bool UArcadeVehicleMovementComponentBase::UsesInterpolation() const
+{
+	/* Server keeps simulating remote vehicles, so its authoritative state is not delayed. Kinematic proxies are always interpolated. */
+	return (Settings.Network.SmoothingMode == VehicleSmoothingMode::Interpolation || bIsKinematicProxy) && GetOwnerRole() != ROLE_Authority && !HasControlOverVehicle();
+}
+
+void UArcadeVehicleMovementComponentBase::ApplyInterpolation()
+{
+	/* Render the vehicle in the past, delayed by the size of the jitter buffer. */
+	const double currentTime = GetWorld()->GetTimeSeconds();
+	const float delay = JitterBuffer.GetDelay(Settings.Network.MinInterpolationDelay * 0.001f, Settings.Network.MaxInterpolationDelay * 0.001f, Settings.Network.JitterDeviationMultiplier);
+	FVehiclePhysicsState sampledState;
+	float extrapolationTime = 0.f;
+	if(!JitterBuffer.Sample(currentTime - delay, Settings.Network.MaxExtrapolationTime * 0.001f, sampledState, extrapolationTime))
+	{
+		return;
+	}
+
+	/* Apply sampled state to the physics. Kinematic body only takes the transform. */
+	PhysicsPrimitive->SetWorldLocationAndRotation(sampledState.Location, sampledState.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	if(PhysicsPrimitive->IsSimulatingPhysics())
+	{
+		PhysicsPrimitive->SetPhysicsLinearVelocity(sampledState.LinearVelocity);
+		PhysicsPrimitive->SetPhysicsAngularVelocityInDegrees(sampledState.AngularVelocity);
+	}
+
+	/* Ensure local friction doesn't fight the interpolation. */
+	if(PhysicsRuntime.bHasLastTotalFriction)
+	{
+		PhysicsRuntime.TotalFrictionSnapLocation = sampledState.Location;
+	}
+
+	JitterBuffer.ClearOldStates(currentTime - delay);
+	NetTelemetry.AddInterpolationSample(delay, extrapolationTime);
+}
+
+void UArcadeVehicleMovementComponentBase::UpdateKinematicProxy()
+{
+	/* Only simulated proxies on clients can become kinematic. Physics disabled for other reasons is left alone. */
+	bool bShouldBeKinematic = false;
+	const bool bCanBeKinematic = GetOwnerRole() == ROLE_SimulatedProxy && (bIsKinematicProxy || PhysicsPrimitive->IsSimulatingPhysics());
+
+	/* Interpolated vehicles are rendered exactly at the sampled states, so neither the forces nor the physics step may move them on their own. */
+	if(bCanBeKinematic && Settings.Network.SmoothingMode == VehicleSmoothingMode::Interpolation)
+	{
+		bShouldBeKinematic = true;
+	}
+	else if(bCanBeKinematic && Settings.Network.KinematicProxyDistance > 0.f)
+	{
+		const APlayerController* pPlayerController = GetWorld()->GetFirstPlayerController();
+		if(IsValid(pPlayerController))
+		{
+			FVector viewLocation;
+			FRotator viewRotation;
+			pPlayerController->GetPlayerViewPoint(viewLocation, viewRotation);
+
+			/* Vehicle has to come a bit closer to resume simulation, so it doesn't flicker between the modes at the border. */
+			const float switchDistance = bIsKinematicProxy ? Settings.Network.KinematicProxyDistance * 0.9f : Settings.Network.KinematicProxyDistance;
+			bShouldBeKinematic = FVector::DistSquared(viewLocation, PhysicsPrimitive->GetComponentLocation()) > FMath::Square(switchDistance);
+		}
+	}
+
+	if(bShouldBeKinematic == bIsKinematicProxy)
+	{
+		return;
+	}
+	bIsKinematicProxy = bShouldBeKinematic;
+
+	if(bIsKinematicProxy)
+	{
+		/*
+		 * Seed the buffer with the state the vehicle is at, rendered with the current delay, so it keeps going until received states take over instead of jumping to them.
+		 * Interpolated vehicles have been filling the buffer all along, so theirs is left as it is.
+		 */
+		if(JitterBuffer.Num() == 0)
+		{
+			FVehiclePhysicsState seedState = BuildState();
+			seedState.TimeStamp = GetWorld()->GetTimeSeconds() - JitterBuffer.GetDelay(Settings.Network.MinInterpolationDelay * 0.001f, Settings.Network.MaxInterpolationDelay * 0.001f, Settings.Network.JitterDeviationMultiplier);
+			JitterBuffer.SeedState(seedState);
+		}
+
+		/* Stop simulating, received states will drive the body from now on. */
+		PhysicsPrimitive->SetSimulatePhysics(false);
+		LocationCorrection.Reset();
+		RotationCorrection.Reset();
+		LinearVelocityCorrection.Reset();
+		AngularVelocityCorrection.Reset();
+	}
+	else
+	{
+		/* Resume simulation from the latest interpolated state, including its velocities. */
+		PhysicsPrimitive->SetSimulatePhysics(true);
+		ApplyInterpolation();
+		StateBuffer.Clear();
+		if(!UsesInterpolation())
+		{
+			JitterBuffer.Clear();
+		}
+	}
+}
+
 float UArcadeVehicleMovementComponentBase::AngularDistance(const FQuat& A, const FQuat& B)
 {
 	return FMath::RadiansToDegrees(A.AngularDistance(B));
 }
+
+FVehiclePhysicsState UArcadeVehicleMovementComponentBase::ExtrapolateState(const FVehiclePhysicsState& State, float Time)
+{
+	FVehiclePhysicsState outState = State;
+	outState.Location = State.Location + State.LinearVelocity * Time;
+	const FVector rotationVector = FMath::DegreesToRadians(FVector(State.AngularVelocity)) * Time;
+	const float angle = rotationVector.Size();
+	if(angle > UE_SMALL_NUMBER)
+	{
+		outState.Rotation = (FQuat(rotationVector / angle, angle) * State.Rotation.Quaternion()).GetNormalized().Rotator();
+	}
+	return outState;
+}
@@ -53,6 +53,12 @@ bool UStaticArcadeVehicleMovementComponent::InitializeVehicleMovement()
 		{
 			pExistingAnimator->DestroyComponent();
 		}
+
+		/* Dedicated server renders nothing, so it never needs one. */
+		if(IsRunningDedicatedServer())
+		{
+			return true;
+		}
 		VehicleAnimatorInstance = NewObject<UStaticArcadeVehicleAnimator>(GetOwner(), AnimatorClass);
 		VehicleAnimatorInstance->RegisterComponent();
 	}
@@ -103,7 +109,7 @@ void UStaticArcadeVehicleMovementComponent::SetAnimatorClass(
 	AnimatorClass = NewAnimatorClass;
 
 	/* If we already have valid animator, we need to replace it. */
-	if(IsValid(VehicleAnimatorInstance))
+	if(IsValid(VehicleAnimatorInstance) && !IsRunningDedicatedServer())
 	{
 		VehicleAnimatorInstance->DestroyComponent();
 		VehicleAnimatorInstance = NewObject<UStaticArcadeVehicleAnimator>(GetOwner(), AnimatorClass);
@@ -131,9 +137,12 @@ bool UStaticArcadeVehicleMovementComponent::SetVehicleAnimatorClass(
 		VehicleAnimatorInstance = nullptr;
 	}
 
-	/* Create a new animation instance. */
-	VehicleAnimatorInstance = NewObject<UStaticArcadeVehicleAnimator>(GetOwner(), AnimatorClass);
-	VehicleAnimatorInstance->RegisterComponent();
+	/* Create a new animation instance. Not on the dedicated server, where the class is only remembered. */
+	if(!IsRunningDedicatedServer())
+	{
+		VehicleAnimatorInstance = NewObject<UStaticArcadeVehicleAnimator>(GetOwner(), AnimatorClass);
+		VehicleAnimatorInstance->RegisterComponent();
+	}
 
 	/* Success. */
 	return true;
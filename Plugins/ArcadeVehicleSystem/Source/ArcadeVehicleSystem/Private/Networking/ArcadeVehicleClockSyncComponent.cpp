@@ -0,0 +1,190 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#include "Networking/ArcadeVehicleClockSyncComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/GameStateBase.h"
+#include "Engine/World.h"
+
+UArcadeVehicleClockSyncComponent::UArcadeVehicleClockSyncComponent()
+{
+	/* Allow replication, so the rpcs work. */
+	SetIsReplicatedByDefault(true);
+
+	/* Ticking is only needed for sending pings. */
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = true;
+
+	PingInterval = 0.5f;
+	SampleWindowSize = 32;
+	MinSynchronizedSamples = 4;
+	BestSamplesFraction = 0.25f;
+	Offset = 0.0;
+	Drift = 0.0;
+	ReferenceTime = 0.0;
+	MinRoundTripTime = 0.0;
+	TimeToNextPing = 0.f;
+}
+
+void UArcadeVehicleClockSyncComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	/* Only the owning client pings, server clock is the local clock for the server. */
+	const APlayerController* pPlayerController = Cast<APlayerController>(GetOwner());
+	if(!IsValid(pPlayerController) || !pPlayerController->IsLocalController() || GetOwnerRole() == ROLE_Authority)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	TimeToNextPing -= DeltaTime;
+	if(TimeToNextPing <= 0.f)
+	{
+		TimeToNextPing = PingInterval;
+		OnReceivePing_Server(GetLocalTime());
+	}
+}
+
+const UArcadeVehicleClockSyncComponent* UArcadeVehicleClockSyncComponent::GetLocalClock(const UWorld* World)
+{
+	if(!IsValid(World) || World->GetNetMode() != NM_Client)
+	{
+		return nullptr;
+	}
+
+	const APlayerController* pPlayerController = World->GetFirstPlayerController();
+	return IsValid(pPlayerController) ? pPlayerController->FindComponentByClass<UArcadeVehicleClockSyncComponent>() : nullptr;
+}
+
+double UArcadeVehicleClockSyncComponent::LocalToServerTime(const UWorld* World, double LocalTime)
+{
+	/* Local clock is the server clock everywhere but on the clients. */
+	if(!IsValid(World) || World->GetNetMode() != NM_Client)
+	{
+		return LocalTime;
+	}
+
+	const UArcadeVehicleClockSyncComponent* pClock = GetLocalClock(World);
+	return IsValid(pClock) && pClock->IsSynchronized() ? pClock->LocalToServerTime(LocalTime) : LocalTime + GetEstimatedOffset(World);
+}
+
+double UArcadeVehicleClockSyncComponent::ServerToLocalTime(const UWorld* World, double ServerTime)
+{
+	if(!IsValid(World) || World->GetNetMode() != NM_Client)
+	{
+		return ServerTime;
+	}
+
+	const UArcadeVehicleClockSyncComponent* pClock = GetLocalClock(World);
+	return IsValid(pClock) && pClock->IsSynchronized() ? pClock->ServerToLocalTime(ServerTime) : ServerTime - GetEstimatedOffset(World);
+}
+
+double UArcadeVehicleClockSyncComponent::LocalToServerTime(double LocalTime) const
+{
+	return LocalTime + Offset + Drift * (LocalTime - ReferenceTime);
+}
+
+double UArcadeVehicleClockSyncComponent::ServerToLocalTime(double ServerTime) const
+{
+	/* Inverse of the local to server conversion. */
+	return (ServerTime - Offset + Drift * ReferenceTime) / (1.0 + Drift);
+}
+
+double UArcadeVehicleClockSyncComponent::GetServerTime() const
+{
+	return LocalToServerTime(GetLocalTime());
+}
+
+bool UArcadeVehicleClockSyncComponent::IsSynchronized() const
+{
+	/* Single sample may well be an outlier, best samples filter and drift fit only mean something with a few of them. */
+	return Samples.Num() >= FMath::Clamp(MinSynchronizedSamples, 1, SampleWindowSize);
+}
+
+double UArcadeVehicleClockSyncComponent::GetMinRoundTripTime() const
+{
+	return MinRoundTripTime;
+}
+
+void UArcadeVehicleClockSyncComponent::OnReceivePing_Server_Implementation(double ClientTime)
+{
+	OnReceivePong_Client(ClientTime, GetLocalTime());
+}
+
+void UArcadeVehicleClockSyncComponent::OnReceivePong_Client_Implementation(double ClientTime, double ServerTime)
+{
+	/* Assume symmetric path, so the server time was taken in the middle of the round trip. */
+	const double localTime = GetLocalTime();
+	FVehicleClockSample sample;
+	sample.LocalTime = localTime;
+	sample.RoundTripTime = localTime - ClientTime;
+	sample.Offset = ServerTime + sample.RoundTripTime * 0.5 - localTime;
+
+	/* Keep the window of the latest samples. */
+	if(Samples.Num() >= SampleWindowSize)
+	{
+#if UE_5_6_OR_LATER
+		Samples.RemoveAt(0, Samples.Num() - SampleWindowSize + 1, EAllowShrinking::No);
+#else
+		Samples.RemoveAt(0, Samples.Num() - SampleWindowSize + 1, false);
+#endif
+	}
+	Samples.Add(sample);
+
+	UpdateEstimate();
+}
+
+void UArcadeVehicleClockSyncComponent::UpdateEstimate()
+{
+	/* Take samples with the lowest round trip time. */
+	TArray<FVehicleClockSample, TInlineAllocator<64>> bestSamples(Samples);
+	bestSamples.Sort([](const FVehicleClockSample& A, const FVehicleClockSample& B)
+	{
+		return A.RoundTripTime < B.RoundTripTime;
+	});
+	MinRoundTripTime = bestSamples[0].RoundTripTime;
+	bestSamples.SetNum(FMath::Max(1, FMath::CeilToInt(bestSamples.Num() * BestSamplesFraction)));
+
+	/* Fit a line through offsets of the best samples. Slope is the drift of the server clock. */
+	double meanTime = 0.0;
+	double meanOffset = 0.0;
+	for(const FVehicleClockSample& sample : bestSamples)
+	{
+		meanTime += sample.LocalTime;
+		meanOffset += sample.Offset;
+	}
+	meanTime /= bestSamples.Num();
+	meanOffset /= bestSamples.Num();
+
+	double covariance = 0.0;
+	double variance = 0.0;
+	for(const FVehicleClockSample& sample : bestSamples)
+	{
+		covariance += (sample.LocalTime - meanTime) * (sample.Offset - meanOffset);
+		variance += FMath::Square(sample.LocalTime - meanTime);
+	}
+
+	/* Drift needs samples spread in time, otherwise only the offset is trusted. */
+	Drift = variance > 1.0 ? covariance / variance : 0.0;
+	Offset = meanOffset;
+	ReferenceTime = meanTime;
+}
+
+double UArcadeVehicleClockSyncComponent::GetLocalTime() const
+{
+	return GetWorld()->GetTimeSeconds();
+}
+
+double UArcadeVehicleClockSyncComponent::GetEstimatedOffset(const UWorld* World)
+{
+	const AGameStateBase* pGameState = World->GetGameState();
+	if(!IsValid(pGameState))
+	{
+		return 0.0;
+	}
+
+	const APlayerController* pPlayerController = World->GetFirstPlayerController();
+	const double halfRoundTripTime = IsValid(pPlayerController) && IsValid(pPlayerController->PlayerState) ? pPlayerController->PlayerState->ExactPing * 0.001 * 0.5 : 0.0;
+	return pGameState->GetServerWorldTimeSeconds() + halfRoundTripTime - World->GetTimeSeconds();
+}
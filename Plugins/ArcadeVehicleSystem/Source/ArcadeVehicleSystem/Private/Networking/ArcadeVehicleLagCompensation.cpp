@@ -0,0 +1,376 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#include "Networking/ArcadeVehicleLagCompensation.h"
+#include "Movement/ArcadeVehicleMovementComponentBase.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace ArcadeVehicleLagCompensation
+{
+	/** Transforms world location to the space of the vehicle box, with the box center at the origin. */
+	static FVector ToBoxSpace(const FVehicleRewindHistory& History, const FTransform& Transform, const FVector& Location)
+	{
+		return Transform.GetRotation().UnrotateVector(Location - Transform.GetLocation()) - History.LocalCenter;
+	}
+
+	/** Returns distance from given box space location to the box. Zero if the location is inside. */
+	static double GetDistanceToBox(const FVehicleRewindHistory& History, const FVector& BoxLocation)
+	{
+		const FVector closest = BoxLocation.BoundToBox(-History.LocalExtent, History.LocalExtent);
+		return FVector::Dist(BoxLocation, closest);
+	}
+
+	/** Slab test of the box space segment against the box. Returns entry time along the segment in 0-1 range, or false if it misses. */
+	static bool IntersectSegmentBox(const FVehicleRewindHistory& History, const FVector& BoxStart, const FVector& BoxEnd, double& OutTime)
+	{
+		const FVector direction = BoxEnd - BoxStart;
+		double entry = 0.0;
+		double exit = 1.0;
+		for(int32 axis = 0; axis < 3; ++axis)
+		{
+			if(FMath::IsNearlyZero(direction[axis]))
+			{
+				/* Parallel to the slab, it has to start inside of it. */
+				if(FMath::Abs(BoxStart[axis]) > History.LocalExtent[axis])
+				{
+					return false;
+				}
+				continue;
+			}
+
+			double t0 = (-History.LocalExtent[axis] - BoxStart[axis]) / direction[axis];
+			double t1 = (History.LocalExtent[axis] - BoxStart[axis]) / direction[axis];
+			if(t0 > t1)
+			{
+				Swap(t0, t1);
+			}
+			entry = FMath::Max(entry, t0);
+			exit = FMath::Min(exit, t1);
+			if(entry > exit)
+			{
+				return false;
+			}
+		}
+
+		OutTime = entry;
+		return true;
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("avs.LagCompensation.Benchmark"),
+		TEXT("Runs rewind queries against the recorded vehicle history and logs the timings. Arguments: [Queries]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(const UArcadeVehicleLagCompensationSubsystem* pLagCompensation = World ? World->GetSubsystem<UArcadeVehicleLagCompensationSubsystem>() : nullptr)
+			{
+				pLagCompensation->RunBenchmark(Args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000);
+			}
+		}));
+}
+
+FVehicleRewindHit::FVehicleRewindHit()
+{
+	Vehicle = nullptr;
+	Location = FVector::ZeroVector;
+	Distance = 0.f;
+}
+
+FVehicleRewindHistory::FVehicleRewindHistory()
+{
+	LocalCenter = FVector::ZeroVector;
+	LocalExtent = FVector::ZeroVector;
+	NextFrame = 0;
+	NumFrames = 0;
+}
+
+void FVehicleRewindHistory::AddFrame(const FVehicleRewindFrame& Frame)
+{
+	/* Keep overwriting the newest frame until the sample interval passes, so high tick rates don't shorten the history, while the newest frame stays current. */
+	if(NumFrames >= 2 && Frame.Time - GetFrame(NumFrames - 2).Time < SampleInterval)
+	{
+		Frames[(NextFrame - 1 + MaxFrames) % MaxFrames] = Frame;
+		return;
+	}
+
+	Frames[NextFrame] = Frame;
+	NextFrame = (NextFrame + 1) % MaxFrames;
+	NumFrames = FMath::Min(NumFrames + 1, MaxFrames);
+}
+
+const FVehicleRewindFrame& FVehicleRewindHistory::GetFrame(int32 Index) const
+{
+	return Frames[(NextFrame - NumFrames + Index + MaxFrames) % MaxFrames];
+}
+
+bool FVehicleRewindHistory::GetTransformAtTime(double Time, FTransform& OutTransform) const
+{
+	if(NumFrames == 0)
+	{
+		return false;
+	}
+
+	/* Find the first frame newer than requested time. */
+	int32 low = 0;
+	int32 high = NumFrames;
+	while(low < high)
+	{
+		const int32 middle = (low + high) / 2;
+		if(GetFrame(middle).Time <= Time)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	/* Clamp to the history if the time is out of it. */
+	if(low == 0 || low == NumFrames)
+	{
+		const FVehicleRewindFrame& frame = GetFrame(low == 0 ? 0 : NumFrames - 1);
+		OutTransform = FTransform(FQuat(frame.Rotation), frame.Location);
+		return true;
+	}
+
+	/* Interpolate between the frames around requested time. */
+	const FVehicleRewindFrame& from = GetFrame(low - 1);
+	const FVehicleRewindFrame& to = GetFrame(low);
+	const float alpha = static_cast<float>((Time - from.Time) / FMath::Max(to.Time - from.Time, UE_DOUBLE_SMALL_NUMBER));
+	OutTransform = FTransform(FQuat(FQuat4f::Slerp(from.Rotation, to.Rotation, alpha)), FMath::Lerp(from.Location, to.Location, static_cast<double>(alpha)));
+	return true;
+}
+
+void UArcadeVehicleLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	/* Record current transforms of all vehicles. */
+	const double time = GetWorld()->GetTimeSeconds();
+	for(int32 i = Histories.Num() - 1; i >= 0; --i)
+	{
+		FVehicleRewindHistory& history = *Histories[i];
+		const UArcadeVehicleMovementComponentBase* pVehicle = history.Vehicle.Get();
+		if(!IsValid(pVehicle))
+		{
+#if UE_5_6_OR_LATER
+			Histories.RemoveAtSwap(i, 1, EAllowShrinking::No);
+#else
+			Histories.RemoveAtSwap(i, 1, false);
+#endif
+			continue;
+		}
+
+		const UPrimitiveComponent* pMesh = pVehicle->GetVehicleMesh();
+		if(!IsValid(pMesh))
+		{
+			continue;
+		}
+
+		/* Bounds are taken once the mesh is available. They are kept in local space, so they rotate with the recorded frames. */
+		if(history.LocalExtent.IsZero())
+		{
+			const FBoxSphereBounds bounds = pMesh->CalcLocalBounds();
+			const FVector scale = pMesh->GetComponentScale().GetAbs();
+			history.LocalCenter = bounds.Origin * scale;
+			history.LocalExtent = bounds.BoxExtent * scale;
+		}
+
+		FVehicleRewindFrame frame;
+		frame.Time = time;
+		frame.Location = pMesh->GetComponentLocation();
+		frame.Rotation = FQuat4f(pMesh->GetComponentQuat());
+		history.AddFrame(frame);
+	}
+}
+
+TStatId UArcadeVehicleLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UArcadeVehicleLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+bool UArcadeVehicleLagCompensationSubsystem::IsTickable() const
+{
+	return Histories.Num() > 0;
+}
+
+void UArcadeVehicleLagCompensationSubsystem::RegisterVehicle(UArcadeVehicleMovementComponentBase* Vehicle)
+{
+	if(!IsValid(Vehicle))
+	{
+		return;
+	}
+
+	for(const TUniquePtr<FVehicleRewindHistory>& history : Histories)
+	{
+		if(history->Vehicle == Vehicle)
+		{
+			return;
+		}
+	}
+
+	TUniquePtr<FVehicleRewindHistory>& history = Histories.Add_GetRef(MakeUnique<FVehicleRewindHistory>());
+	history->Vehicle = Vehicle;
+}
+
+void UArcadeVehicleLagCompensationSubsystem::UnregisterVehicle(UArcadeVehicleMovementComponentBase* Vehicle)
+{
+	Histories.RemoveAllSwap([Vehicle](const TUniquePtr<FVehicleRewindHistory>& History)
+	{
+		return History->Vehicle == Vehicle;
+	});
+}
+
+bool UArcadeVehicleLagCompensationSubsystem::GetVehicleTransformAtTime(const UArcadeVehicleMovementComponentBase* Vehicle, double Time, FTransform& OutTransform) const
+{
+	for(const TUniquePtr<FVehicleRewindHistory>& history : Histories)
+	{
+		if(history->Vehicle == Vehicle)
+		{
+			return history->GetTransformAtTime(Time, OutTransform);
+		}
+	}
+
+	return false;
+}
+
+void UArcadeVehicleLagCompensationSubsystem::OverlapVehiclesAtTime(const FVector& Location, float Radius, double Time, TArray<UArcadeVehicleMovementComponentBase*>& OutVehicles) const
+{
+	for(const TUniquePtr<FVehicleRewindHistory>& history : Histories)
+	{
+		FTransform transform;
+		if(!history->Vehicle.IsValid() || !history->GetTransformAtTime(Time, transform))
+		{
+			continue;
+		}
+
+		const FVector boxLocation = ArcadeVehicleLagCompensation::ToBoxSpace(*history, transform, Location);
+		if(ArcadeVehicleLagCompensation::GetDistanceToBox(*history, boxLocation) <= Radius)
+		{
+			OutVehicles.Add(history->Vehicle.Get());
+		}
+	}
+}
+
+bool UArcadeVehicleLagCompensationSubsystem::RaycastVehiclesAtTime(const FVector& Start, const FVector& End, double Time, FVehicleRewindHit& OutHit) const
+{
+	double closestTime = TNumericLimits<double>::Max();
+	for(const TUniquePtr<FVehicleRewindHistory>& history : Histories)
+	{
+		FTransform transform;
+		if(!history->Vehicle.IsValid() || !history->GetTransformAtTime(Time, transform))
+		{
+			continue;
+		}
+
+		const FVector boxStart = ArcadeVehicleLagCompensation::ToBoxSpace(*history, transform, Start);
+		const FVector boxEnd = ArcadeVehicleLagCompensation::ToBoxSpace(*history, transform, End);
+		double hitTime;
+		if(ArcadeVehicleLagCompensation::IntersectSegmentBox(*history, boxStart, boxEnd, hitTime) && hitTime < closestTime)
+		{
+			closestTime = hitTime;
+			OutHit.Vehicle = history->Vehicle.Get();
+		}
+	}
+
+	if(closestTime > 1.0)
+	{
+		return false;
+	}
+
+	OutHit.Location = FMath::Lerp(Start, End, closestTime);
+	OutHit.Distance = static_cast<float>(FVector::Dist(Start, OutHit.Location));
+	return true;
+}
+
+UArcadeVehicleMovementComponentBase* UArcadeVehicleLagCompensationSubsystem::FindNearestVehicleAtTime(const FVector& Location, double Time, float& OutDistance) const
+{
+	UArcadeVehicleMovementComponentBase* pNearest = nullptr;
+	double nearestDistance = TNumericLimits<double>::Max();
+	for(const TUniquePtr<FVehicleRewindHistory>& history : Histories)
+	{
+		FTransform transform;
+		if(!history->Vehicle.IsValid() || !history->GetTransformAtTime(Time, transform))
+		{
+			continue;
+		}
+
+		const FVector boxLocation = ArcadeVehicleLagCompensation::ToBoxSpace(*history, transform, Location);
+		const double distance = ArcadeVehicleLagCompensation::GetDistanceToBox(*history, boxLocation);
+		if(distance < nearestDistance)
+		{
+			nearestDistance = distance;
+			pNearest = history->Vehicle.Get();
+		}
+	}
+
+	OutDistance = pNearest ? static_cast<float>(nearestDistance) : 0.f;
+	return pNearest;
+}
+
+void UArcadeVehicleLagCompensationSubsystem::RunBenchmark(int32 Queries) const
+{
+	/* Take the time range covered by all of the histories, so the queries hit recorded frames. */
+	double oldestTime = TNumericLimits<double>::Max();
+	double newestTime = TNumericLimits<double>::Lowest();
+	int32 numFrames = 0;
+	for(const TUniquePtr<FVehicleRewindHistory>& history : Histories)
+	{
+		if(history->NumFrames > 0)
+		{
+			oldestTime = FMath::Min(oldestTime, history->GetFrame(0).Time);
+			newestTime = FMath::Max(newestTime, history->GetFrame(history->NumFrames - 1).Time);
+			numFrames += history->NumFrames;
+		}
+	}
+	if(numFrames == 0)
+	{
+		UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("Lag compensation benchmark: no vehicle history recorded."));
+		return;
+	}
+
+	/* Queries are placed around random vehicles at random times. */
+	FRandomStream random(Histories.Num());
+	TArray<FVector> locations;
+	TArray<double> times;
+	locations.Reserve(Queries);
+	times.Reserve(Queries);
+	for(int32 i = 0; i < Queries; ++i)
+	{
+		const FVehicleRewindHistory& history = *Histories[random.RandHelper(Histories.Num())];
+		const FVector origin = history.NumFrames > 0 ? history.GetFrame(history.NumFrames - 1).Location : FVector::ZeroVector;
+		locations.Add(origin + random.GetUnitVector() * random.FRandRange(0.f, 1000.f));
+		times.Add(FMath::Lerp(oldestTime, newestTime, static_cast<double>(random.GetFraction())));
+	}
+
+	TArray<UArcadeVehicleMovementComponentBase*> overlaps;
+	const double overlapStart = FPlatformTime::Seconds();
+	for(int32 i = 0; i < Queries; ++i)
+	{
+		overlaps.Reset();
+		OverlapVehiclesAtTime(locations[i], 200.f, times[i], overlaps);
+	}
+
+	FVehicleRewindHit hit;
+	const double raycastStart = FPlatformTime::Seconds();
+	for(int32 i = 0; i < Queries; ++i)
+	{
+		RaycastVehiclesAtTime(locations[i], locations[(i + 1) % Queries], times[i], hit);
+	}
+
+	float distance;
+	const double nearestStart = FPlatformTime::Seconds();
+	for(int32 i = 0; i < Queries; ++i)
+	{
+		FindNearestVehicleAtTime(locations[i], times[i], distance);
+	}
+	const double endTime = FPlatformTime::Seconds();
+
+	const double toMicroseconds = 1000000.0 / Queries;
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("Lag compensation benchmark: %d vehicles, %d frames, %.2fs of history, %d queries each."),
+		Histories.Num(), numFrames, newestTime - oldestTime, Queries);
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("  Overlap: %.2fus per query"), (raycastStart - overlapStart) * toMicroseconds);
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("  Raycast: %.2fus per query"), (nearestStart - raycastStart) * toMicroseconds);
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("  Nearest: %.2fus per query"), (endTime - nearestStart) * toMicroseconds);
+}
@@ -0,0 +1,305 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#include "Networking/ArcadeVehicleNetHarness.h"
+#include "Movement/ArcadeVehicleMovementComponentBase.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+namespace ArcadeVehicleNetHarness
+{
+	/** Role names used in the report. */
+	enum ERole : uint8
+	{
+		Controlled,
+		ServerProxy,
+		ClientProxy,
+		Count
+	};
+	static const TCHAR* RoleNames[Count] = { TEXT("Controlled"), TEXT("ServerProxy"), TEXT("ClientProxy") };
+
+	/** Returns all initialized vehicles of the world. */
+	static void GetVehicles(const UWorld* World, TArray<UArcadeVehicleMovementComponentBase*>& OutVehicles)
+	{
+		for(TObjectIterator<UArcadeVehicleMovementComponentBase> it; it; ++it)
+		{
+			if(it->GetWorld() == World && IsValid(it->GetPawnOwner()) && IsValid(it->GetVehicleMesh()))
+			{
+				OutVehicles.Add(*it);
+			}
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs StartCommand(
+		TEXT("avs.NetHarness.Start"),
+		TEXT("Starts arcade vehicle network harness. Arguments: [LagMs] [JitterMs] [LossPercent]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(UArcadeVehicleNetHarnessSubsystem* pHarness = World ? World->GetSubsystem<UArcadeVehicleNetHarnessSubsystem>() : nullptr)
+			{
+				const int32 lag = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 0;
+				const int32 jitter = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 0;
+				const int32 loss = Args.IsValidIndex(2) ? FCString::Atoi(*Args[2]) : 0;
+				pHarness->StartHarness(lag, jitter, loss);
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("avs.NetHarness.Report"),
+		TEXT("Logs arcade vehicle network harness results gathered so far."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(const UArcadeVehicleNetHarnessSubsystem* pHarness = World ? World->GetSubsystem<UArcadeVehicleNetHarnessSubsystem>() : nullptr)
+			{
+				pHarness->ReportHarness();
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs StopCommand(
+		TEXT("avs.NetHarness.Stop"),
+		TEXT("Stops arcade vehicle network harness and logs its results."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			if(UArcadeVehicleNetHarnessSubsystem* pHarness = World ? World->GetSubsystem<UArcadeVehicleNetHarnessSubsystem>() : nullptr)
+			{
+				pHarness->StopHarness();
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs DumpTelemetryCommand(
+		TEXT("avs.Net.DumpTelemetry"),
+		TEXT("Logs network telemetry table of all arcade vehicles in the world. Telemetry is gathered only while avs.Net.Telemetry is enabled."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			TArray<UArcadeVehicleMovementComponentBase*> vehicles;
+			GetVehicles(World, vehicles);
+			UE_LOG(LogArcadeVehicleMovement, Log, TEXT("%-32s %-12s %-8s %8s %7s %10s %10s %8s %17s %17s %17s %6s %6s %11s"),
+				TEXT("Vehicle"), TEXT("Role"), TEXT("Smooth"), TEXT("Delay ms"), TEXT("Extrap"), TEXT("Payload Tx"), TEXT("Payload Rx"), TEXT("States/s"),
+				TEXT("Loc err avg/max"), TEXT("Rot err avg/max"), TEXT("Vel err avg/max"), TEXT("LSnaps"), TEXT("RSnaps"), TEXT("Buf avg/max"));
+			for(const UArcadeVehicleMovementComponentBase* pVehicle : vehicles)
+			{
+				const ERole role = pVehicle->HasControlOverVehicle() ? Controlled : pVehicle->GetOwnerRole() == ROLE_Authority ? ServerProxy : ClientProxy;
+				const FVehicleNetTelemetry& telemetry = pVehicle->GetNetTelemetry();
+				const float corrections = FMath::Max(telemetry.CorrectionsCount, 1);
+				const float bufferSamples = FMath::Max(telemetry.BufferSamples, 1);
+				UE_LOG(LogArcadeVehicleMovement, Log, TEXT("%-32s %-12s %-8s %8.1f %7d %10lld %10lld %8.1f %8.2f/%8.2f %8.2f/%8.2f %8.2f/%8.2f %6d %6d %5.1f/%5d"),
+					*GetNameSafe(pVehicle->GetPawnOwner()), RoleNames[role],
+					telemetry.bIsInterpolating ? TEXT("Interp") : TEXT("Correct"), telemetry.InterpolationDelay * 1000.f, telemetry.ExtrapolatedFrames,
+					telemetry.BytesSent, telemetry.BytesReceived, telemetry.GetStatesPerSecond(),
+					telemetry.LocationErrorSum / corrections, telemetry.LocationErrorMax,
+					telemetry.RotationErrorSum / corrections, telemetry.RotationErrorMax,
+					telemetry.VelocityErrorSum / corrections, telemetry.VelocityErrorMax,
+					telemetry.LocationSnaps, telemetry.RotationSnaps,
+					telemetry.BufferOccupancySum / bufferSamples, telemetry.BufferOccupancyMax);
+			}
+		}));
+}
+
+UArcadeVehicleNetHarnessSubsystem::UArcadeVehicleNetHarnessSubsystem()
+{
+	bIsRunning = false;
+	StartTime = 0.0;
+	StartBytesIn = 0;
+	StartBytesOut = 0;
+}
+
+void UArcadeVehicleNetHarnessSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	/* Drive all of the vehicles we control with scripted inputs. Each vehicle gets its own phase, so they don't move in sync. */
+	TArray<UArcadeVehicleMovementComponentBase*> vehicles;
+	ArcadeVehicleNetHarness::GetVehicles(GetWorld(), vehicles);
+	const float time = static_cast<float>(FPlatformTime::Seconds() - StartTime);
+	for(int32 i = 0; i < vehicles.Num(); ++i)
+	{
+		UArcadeVehicleMovementComponentBase* pVehicle = vehicles[i];
+		if(!pVehicle->HasControlOverVehicle())
+		{
+			continue;
+		}
+		const float phase = time * 0.5f + i * 1.3f;
+		pVehicle->SetAccelerationInput(FMath::Sin(phase * 0.7f) > -0.8f ? 1.f : -1.f);
+		pVehicle->SetTurningInput(FMath::Sin(phase));
+		pVehicle->SetDriftInput(FMath::Sin(phase * 0.3f) > 0.9f);
+	}
+}
+
+TStatId UArcadeVehicleNetHarnessSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UArcadeVehicleNetHarnessSubsystem, STATGROUP_Tickables);
+}
+
+bool UArcadeVehicleNetHarnessSubsystem::IsTickable() const
+{
+	return bIsRunning;
+}
+
+void UArcadeVehicleNetHarnessSubsystem::StartHarness(int32 LagMs, int32 JitterMs, int32 LossPercent)
+{
+	/* Start with clean telemetry, and make sure it is gathered. */
+	if(IConsoleVariable* pTelemetryVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("avs.Net.Telemetry")))
+	{
+		pTelemetryVariable->Set(true, ECVF_SetByCode);
+	}
+	if(!FVehicleNetTelemetry::IsEnabled())
+	{
+		UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("Net harness telemetry is not available in this build configuration."));
+	}
+
+	TArray<UArcadeVehicleMovementComponentBase*> vehicles;
+	ArcadeVehicleNetHarness::GetVehicles(GetWorld(), vehicles);
+	for(UArcadeVehicleMovementComponentBase* pVehicle : vehicles)
+	{
+		pVehicle->ResetNetTelemetry();
+	}
+
+	ApplyPacketSimulation(LagMs, JitterMs, LossPercent);
+
+	/* Net driver counts traffic since it was created, so the report takes difference from now. */
+	if(const UNetDriver* pNetDriver = GetWorld()->GetNetDriver())
+	{
+		StartBytesIn = pNetDriver->InTotalBytes;
+		StartBytesOut = pNetDriver->OutTotalBytes;
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	bIsRunning = true;
+
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("Net harness started. Lag: %d ms, jitter: %d ms, loss: %d%%, vehicles: %d."), LagMs, JitterMs, LossPercent, vehicles.Num());
+}
+
+void UArcadeVehicleNetHarnessSubsystem::StopHarness()
+{
+	if(!bIsRunning)
+	{
+		return;
+	}
+
+	ReportHarness();
+	ApplyPacketSimulation(0, 0, 0);
+	bIsRunning = false;
+
+	/* Release scripted inputs. */
+	TArray<UArcadeVehicleMovementComponentBase*> vehicles;
+	ArcadeVehicleNetHarness::GetVehicles(GetWorld(), vehicles);
+	for(UArcadeVehicleMovementComponentBase* pVehicle : vehicles)
+	{
+		if(pVehicle->HasControlOverVehicle())
+		{
+			pVehicle->ClearInputs();
+		}
+	}
+}
+
+void UArcadeVehicleNetHarnessSubsystem::ReportHarness() const
+{
+	using namespace ArcadeVehicleNetHarness;
+
+	TArray<UArcadeVehicleMovementComponentBase*> vehicles;
+	GetVehicles(GetWorld(), vehicles);
+	const double duration = FMath::Max(FPlatformTime::Seconds() - StartTime, UE_DOUBLE_SMALL_NUMBER);
+
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("Net harness: %.1f s, %d vehicles."), duration, vehicles.Num());
+
+	/* Actual traffic of the net driver, with all headers and acks. It includes everything else replicated in the session as well. */
+	if(const UNetDriver* pNetDriver = GetWorld()->GetNetDriver())
+	{
+		const int32 connections = FMath::Max(pNetDriver->ClientConnections.Num() + (pNetDriver->ServerConnection ? 1 : 0), 1);
+		const double bytesIn = static_cast<double>(pNetDriver->InTotalBytes - StartBytesIn);
+		const double bytesOut = static_cast<double>(pNetDriver->OutTotalBytes - StartBytesOut);
+		UE_LOG(LogArcadeVehicleMovement, Log, TEXT("  Net driver: received %.1f B/s, sent %.1f B/s, %.1f B/s and %.1f B/s per connection, %.1f B/s and %.1f B/s per vehicle."),
+			bytesIn / duration, bytesOut / duration,
+			bytesIn / (duration * connections), bytesOut / (duration * connections),
+			bytesIn / (duration * FMath::Max(vehicles.Num(), 1)), bytesOut / (duration * FMath::Max(vehicles.Num(), 1)));
+	}
+
+	/* Sum telemetry per role. */
+	FVehicleNetTelemetry roleTelemetry[Count];
+	int32 roleVehicles[Count] = {};
+	for(const UArcadeVehicleMovementComponentBase* pVehicle : vehicles)
+	{
+		const ERole role = pVehicle->HasControlOverVehicle() ? Controlled : pVehicle->GetOwnerRole() == ROLE_Authority ? ServerProxy : ClientProxy;
+		const FVehicleNetTelemetry& telemetry = pVehicle->GetNetTelemetry();
+		FVehicleNetTelemetry& total = roleTelemetry[role];
+		for(int32 bucket = 0; bucket < FVehicleNetTelemetry::NumCorrectionBuckets; ++bucket)
+		{
+			total.CorrectionHistogram[bucket] += telemetry.CorrectionHistogram[bucket];
+		}
+		total.BytesSent += telemetry.BytesSent;
+		total.BytesReceived += telemetry.BytesReceived;
+		total.CorrectionsCount += telemetry.CorrectionsCount;
+		total.LocationSnaps += telemetry.LocationSnaps;
+		total.RotationSnaps += telemetry.RotationSnaps;
+		total.SimulationTime += telemetry.SimulationTime;
+		total.SimulationTicks += telemetry.SimulationTicks;
+		total.DroppedInputs += telemetry.DroppedInputs;
+		total.RollbacksCount += telemetry.RollbacksCount;
+		total.RollbackFramesSum += telemetry.RollbackFramesSum;
+		total.RollbackFramesMax = FMath::Max(total.RollbackFramesMax, telemetry.RollbackFramesMax);
+		total.RollbackTimeSum += telemetry.RollbackTimeSum;
+		total.RollbackTimeMax = FMath::Max(total.RollbackTimeMax, telemetry.RollbackTimeMax);
+		++roleVehicles[role];
+	}
+
+	/* Log each role. */
+	for(int32 role = 0; role < Count; ++role)
+	{
+		if(roleVehicles[role] == 0)
+		{
+			continue;
+		}
+
+		const FVehicleNetTelemetry& total = roleTelemetry[role];
+		const double tickTime = total.SimulationTicks > 0 ? total.SimulationTime / total.SimulationTicks * 1000000.0 : 0.0;
+		UE_LOG(LogArcadeVehicleMovement, Log, TEXT("  %s: %d vehicles, %.2f us per tick, %d corrections, %d location snaps, %d rotation snaps."),
+			RoleNames[role], roleVehicles[role], tickTime, total.CorrectionsCount, total.LocationSnaps, total.RotationSnaps);
+
+		/* Payload is taken from the vehicles themselves, so traffic of everything else in the session doesn't count. Headers don't either. */
+		const double bytesToRate = 1.0 / (duration * roleVehicles[role]);
+		UE_LOG(LogArcadeVehicleMovement, Log, TEXT("    Payload sent %.1f B/s, received %.1f B/s per vehicle."), total.BytesSent * bytesToRate, total.BytesReceived * bytesToRate);
+
+		FString histogram;
+		for(int32 bucket = 0; bucket < FVehicleNetTelemetry::NumCorrectionBuckets; ++bucket)
+		{
+			const FString limit = bucket < FVehicleNetTelemetry::NumCorrectionBuckets - 1 ? FString::SanitizeFloat(FVehicleNetTelemetry::GetCorrectionBucketLimit(bucket)) : TEXT("inf");
+			histogram += FString::Printf(TEXT(" <=%s: %d"), *limit, total.CorrectionHistogram[bucket]);
+		}
+		UE_LOG(LogArcadeVehicleMovement, Log, TEXT("    Location error histogram (cm):%s"), *histogram);
+
+		if(total.DroppedInputs > 0)
+		{
+			UE_LOG(LogArcadeVehicleMovement, Log, TEXT("    %d remote inputs dropped."), total.DroppedInputs);
+		}
+
+		if(total.RollbacksCount > 0)
+		{
+			UE_LOG(LogArcadeVehicleMovement, Log, TEXT("    %d rollbacks, %.1f frames avg, %d frames max, %.2f us avg, %.2f us max."),
+				total.RollbacksCount, static_cast<double>(total.RollbackFramesSum) / total.RollbacksCount, total.RollbackFramesMax,
+				total.RollbackTimeSum / total.RollbacksCount * 1000000.0, total.RollbackTimeMax * 1000000.0);
+		}
+	}
+}
+
+bool UArcadeVehicleNetHarnessSubsystem::IsHarnessRunning() const
+{
+	return bIsRunning;
+}
+
+void UArcadeVehicleNetHarnessSubsystem::ApplyPacketSimulation(int32 LagMs, int32 JitterMs, int32 LossPercent)
+{
+#if DO_ENABLE_NET_TEST
+	UNetDriver* pNetDriver = GetWorld()->GetNetDriver();
+	if(IsValid(pNetDriver))
+	{
+		FPacketSimulationSettings packetSimulation;
+		packetSimulation.PktLag = LagMs;
+		packetSimulation.PktLagVariance = JitterMs;
+		packetSimulation.PktLoss = LossPercent;
+		pNetDriver->SetPacketSimulationSettings(packetSimulation);
+	}
+#else
+	UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("Net harness packet simulation is not available in this build configuration."));
+#endif
+}
@@ -1,6 +1,16 @@
 ﻿/** Created and owned by Furious Production LTD @ 2023. **/
 
 #include "Networking/ArcadeVehicleNetSerialization.h"
+#include "HAL/IConsoleManager.h"
+
+namespace ArcadeVehicleNetSerialization
+{
+	static TAutoConsoleVariable<float> CVarLocationCellSize(
+		TEXT("avs.Net.LocationCellSize"),
+		25000.f,
+		TEXT("Size of the grid cell vehicle locations are quantized relative to, in world units. Has to match on the server and the clients, so it can only be set from the config."),
+		ECVF_ReadOnly);
+}
 
 FFloat_NetQuantize FFloat_NetQuantize::ZeroFloat = 0.f;
 
@@ -17,16 +27,127 @@ FFloat_NetQuantize::FFloat_NetQuantize(const float& InValue)
 bool FFloat_NetQuantize::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
 {
 	bOutSuccess = true;
-	int8 compressedFloat = 0;
+	FQuantizer::SerializeValue(Value, Ar);
+	return bOutSuccess;
+}
+
+FTimeStamp_NetQuantize::FTimeStamp_NetQuantize()
+	: Value(0.0)
+{
+}
+
+FTimeStamp_NetQuantize::FTimeStamp_NetQuantize(const double& InValue)
+	: Value(InValue)
+{
+}
+
+bool FTimeStamp_NetQuantize::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+	uint64 packedTicks = Ar.IsSaving() ? ZigZagEncode(ToTicks(Value)) : 0;
+	Ar.SerializeIntPacked64(packedTicks);
+	if(Ar.IsLoading())
+	{
+		Value = FromTicks(ZigZagDecode(packedTicks));
+	}
+
+	return bOutSuccess;
+}
+
+double FVector_NetQuantizeCell::GetCellSize()
+{
+	return FMath::Max(static_cast<double>(ArcadeVehicleNetSerialization::CVarLocationCellSize.GetValueOnAnyThread()), 1.0);
+}
+
+int32 FVector_NetQuantizeCell::GetOffsetSteps()
+{
+	return static_cast<int32>(FMath::RoundToInt64(GetCellSize() * 0.5 * OffsetScale));
+}
+
+uint32 FVector_NetQuantizeCell::GetOffsetBits()
+{
+	return FMath::CeilLogTwo(static_cast<uint32>(GetOffsetSteps()) * 2U + 1U);
+}
+
+void FVector_NetQuantizeCell::QuantizeComponent(double Value, int32& OutCell, int32& OutOffset)
+{
+	/* Nearest cell center, so values around the origin stay in the origin cell on both sides of it. */
+	const double cellSize = GetCellSize();
+	const double cell = FMath::Clamp(FMath::RoundToDouble(Value / cellSize), static_cast<double>(MIN_int32), static_cast<double>(MAX_int32));
+	const int32 offsetSteps = GetOffsetSteps();
+	OutCell = static_cast<int32>(cell);
+	OutOffset = static_cast<int32>(FMath::Clamp<int64>(FMath::RoundToInt64((Value - cell * cellSize) * OffsetScale), -offsetSteps, offsetSteps));
+}
+
+double FVector_NetQuantizeCell::DequantizeComponent(int32 Cell, int32 Offset)
+{
+	const int32 offsetSteps = GetOffsetSteps();
+	return Cell * GetCellSize() + FMath::Clamp(Offset, -offsetSteps, offsetSteps) / OffsetScale;
+}
+
+void FVector_NetQuantizeCell::SerializeCell(FArchive& Ar, int32& Cell)
+{
+	/* Tracks span only a few cells, so small groups keep the common cells at 4 bits. */
+	uint32 value = Ar.IsSaving() ? ZigZagEncode(Cell) : 0;
+	for(uint32 shift = 0; shift < 32; shift += 3)
+	{
+		uint8 group = static_cast<uint8>((value >> shift) & 7);
+		uint8 bHasMore = (value >> shift) > 7;
+		Ar.SerializeBits(&group, 3);
+		Ar.SerializeBits(&bHasMore, 1);
+		if(Ar.IsLoading())
+		{
+			value |= static_cast<uint32>(group) << shift;
+		}
+		if(!bHasMore)
+		{
+			break;
+		}
+	}
+	Cell = ZigZagDecode(value);
+}
+
+bool FVector_NetQuantizeCell::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+	int32 cells[3] = {};
+	int32 offsets[3] = {};
 	if(Ar.IsSaving())
 	{
-		compressedFloat = FMath::RoundToInt(Value * 127.f);
-		Ar.SerializeBits(&compressedFloat, 8);
+		if(ContainsNaN())
+		{
+			logOrEnsureNanError(TEXT("FVector_NetQuantizeCell: Value contains NaN, clearing for safety."));
+			bOutSuccess = false;
+		}
+
+		for(int32 i = 0; i < 3 && bOutSuccess; ++i)
+		{
+			QuantizeComponent(Component(i), cells[i], offsets[i]);
+		}
+	}
+
+	/* Origin cell, which covers small worlds completely, costs single bit. */
+	uint8 bHasCell = cells[0] != 0 || cells[1] != 0 || cells[2] != 0;
+	Ar.SerializeBits(&bHasCell, 1);
+
+	/* Offsets are biased by the max offset, so they are sent as unsigned values. */
+	const int32 offsetSteps = GetOffsetSteps();
+	for(int32 i = 0; i < 3; ++i)
+	{
+		if(bHasCell)
+		{
+			SerializeCell(Ar, cells[i]);
+		}
+		uint32 biasedOffset = static_cast<uint32>(offsets[i] + offsetSteps);
+		Ar.SerializeInt(biasedOffset, static_cast<uint32>(offsetSteps) * 2U + 1U);
+		offsets[i] = static_cast<int32>(biasedOffset) - offsetSteps;
 	}
-	else
+
+	if(Ar.IsLoading())
 	{
-		Ar.SerializeBits(&compressedFloat, 8);
-		Value = compressedFloat / 127.f;
+		X = DequantizeComponent(cells[0], offsets[0]);
+		Y = DequantizeComponent(cells[1], offsets[1]);
+		Z = DequantizeComponent(cells[2], offsets[2]);
 	}
 
 	return bOutSuccess;
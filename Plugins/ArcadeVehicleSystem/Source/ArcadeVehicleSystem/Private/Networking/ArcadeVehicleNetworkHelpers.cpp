@@ -1,10 +1,49 @@
 /** Created and owned by Furious Production LTD @ 2023. **/
 
 #include "Networking/ArcadeVehicleNetworkHelpers.h"
+#include "Serialization/BitWriter.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_STATS_GROUP(TEXT("ArcadeVehicleNet"), STATGROUP_ArcadeVehicleNet, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Payload Bytes Sent"), STAT_ArcadeVehicleNet_BytesSent, STATGROUP_ArcadeVehicleNet);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Payload Bytes Received"), STAT_ArcadeVehicleNet_BytesReceived, STATGROUP_ArcadeVehicleNet);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("States Received"), STAT_ArcadeVehicleNet_StatesReceived, STATGROUP_ArcadeVehicleNet);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Location Snaps"), STAT_ArcadeVehicleNet_LocationSnaps, STATGROUP_ArcadeVehicleNet);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rotation Snaps"), STAT_ArcadeVehicleNet_RotationSnaps, STATGROUP_ArcadeVehicleNet);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Location Error"), STAT_ArcadeVehicleNet_LocationError, STATGROUP_ArcadeVehicleNet);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Rotation Error"), STAT_ArcadeVehicleNet_RotationError, STATGROUP_ArcadeVehicleNet);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Velocity Error"), STAT_ArcadeVehicleNet_VelocityError, STATGROUP_ArcadeVehicleNet);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rollbacks"), STAT_ArcadeVehicleNet_Rollbacks, STATGROUP_ArcadeVehicleNet);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resimulated Frames"), STAT_ArcadeVehicleNet_ResimulatedFrames, STATGROUP_ArcadeVehicleNet);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Resimulation Time (ms)"), STAT_ArcadeVehicleNet_ResimulationTime, STATGROUP_ArcadeVehicleNet);
+CSV_DEFINE_CATEGORY(ArcadeVehicleNet, true);
+
+namespace ArcadeVehicleNetworkHelpers
+{
+	static TAutoConsoleVariable<bool> CVarNetTelemetry(
+		TEXT("avs.Net.Telemetry"),
+		false,
+		TEXT("Gathers network telemetry of the vehicles. Only available in builds with stats or csv profiler. Net harness enables it when started."));
+
+	/**
+	 * Returns size in bytes of given serialization. Writer is shared, so counting doesn't allocate once it has grown.
+	 * Telemetry is only gathered on the game thread.
+	 */
+	template<typename SerializeFunction>
+	static int32 GetSerializedBytes(SerializeFunction Serialize)
+	{
+		check(IsInGameThread());
+		static FBitWriter writer(1024, true);
+		writer.Reset();
+		Serialize(writer);
+		return writer.GetNumBytes();
+	}
+}
 
 FVehiclePhysicsState::FVehiclePhysicsState()
-	: TimeStamp(0.f)
-	, Location(FVector_NetQuantize::ZeroVector)
+	: TimeStamp(0.0)
+	, Location(FVector_NetQuantizeCell::ZeroVector)
 	, Rotation(FRotator::ZeroRotator)
 	, LinearVelocity(FVector_NetQuantize::ZeroVector)
 	, AngularVelocity(FVector_NetQuantize::ZeroVector)
@@ -41,6 +80,74 @@ void FVehiclePhysicsState::SetMovementModifiers(uint8 Modifiers)
 	MovementModifiers = Modifiers;
 }
 
+FVehicleAuthoritativeState::FVehicleAuthoritativeState()
+	: Sequence(0)
+{
+}
+
+FVehicleInputFrame::FVehicleInputFrame()
+	: TimeStamp(0.0)
+	, MovementModifiers(0)
+{
+}
+
+FVehicleInputHistory::FVehicleInputHistory()
+	: Sequence(0)
+{
+}
+
+void FVehicleInputHistory::AddInput(const FVehicleInputState& Input, int32 HistorySize)
+{
+	++Sequence;
+	Inputs.Insert(Input, 0);
+	const int32 maxSize = FMath::Clamp(HistorySize, 1, MaxInputs);
+	if(Inputs.Num() > maxSize)
+	{
+		Inputs.SetNum(maxSize);
+	}
+}
+
+bool FVehicleInputHistory::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint32 count = Inputs.Num();
+	Ar.SerializeInt(count, MaxInputs + 1);
+	Ar << Sequence;
+	if(Ar.IsLoading())
+	{
+		Inputs.SetNum(count);
+	}
+
+	for(int32 i = 0; i < static_cast<int32>(count); ++i)
+	{
+		/* Every input after the newest one starts with a bit telling if it repeats the newer input. */
+		uint8 bRepeatsNewer = 0;
+		if(i > 0)
+		{
+			if(Ar.IsSaving())
+			{
+				bRepeatsNewer = Inputs[i].Equals(Inputs[i - 1]) ? 1 : 0;
+			}
+			Ar.SerializeBits(&bRepeatsNewer, 1);
+		}
+
+		if(bRepeatsNewer)
+		{
+			if(Ar.IsLoading())
+			{
+				Inputs[i] = Inputs[i - 1];
+			}
+		}
+		else
+		{
+			Inputs[i].SerializeCompact(Ar);
+		}
+	}
+
+	return bOutSuccess;
+}
+
 FVehiclePhysicsStateArray::FVehiclePhysicsStateArray()
 	: MaxBufferSize(0)
 {
@@ -94,7 +201,7 @@ bool FVehiclePhysicsStateArray::PullState(FVehiclePhysicsState& OutState)
 	return true;
 }
 
-bool FVehiclePhysicsStateArray::GetSuitableState(float InTime, FVehiclePhysicsState& OutState) const
+bool FVehiclePhysicsStateArray::GetSuitableState(double InTime, FVehiclePhysicsState& OutState) const
 {
 	/* Indexes of begin and end state. */
 	int32 beginStateIndex = INDEX_NONE;
@@ -123,8 +230,8 @@ bool FVehiclePhysicsStateArray::GetSuitableState(float InTime, FVehiclePhysicsSt
 		/* Interpolate states. */
 		const FVehiclePhysicsState& beginState = Buffer[beginStateIndex];
 		const FVehiclePhysicsState& endState = Buffer[endStateIndex];
-		const float ab = endState.TimeStamp - beginState.TimeStamp;
-		const float tb = endState.TimeStamp - InTime;
+		const float ab = static_cast<float>(endState.TimeStamp - beginState.TimeStamp);
+		const float tb = static_cast<float>(endState.TimeStamp - InTime);
 		const float alpha = tb / ab;
 		OutState = FVehiclePhysicsState::Lerp(Buffer[beginStateIndex], Buffer[endStateIndex], alpha);
 		return true;
@@ -164,7 +271,7 @@ void FVehiclePhysicsStateArray::Clear()
 	Buffer.Reset();
 }
 
-void FVehiclePhysicsStateArray::ClearOldStates(float InTime)
+void FVehiclePhysicsStateArray::ClearOldStates(double InTime)
 {
 	/* Run through all states. */
 	for(int32 i = Buffer.Num() - 1; i >= 0; --i)
@@ -186,6 +293,333 @@ void FVehiclePhysicsStateArray::ClearOldStates(float InTime)
 	}
 }
 
+FVehicleJitterBuffer::FVehicleJitterBuffer()
+	: LastArrivalTime(0.0)
+	, ArrivalInterval(0.f)
+	, ArrivalDeviation(0.f)
+	, ArrivalsCount(0)
+{
+	Buffer.Reserve(MaxBufferSize);
+}
+
+void FVehicleJitterBuffer::AddState(const FVehiclePhysicsState& State, double ArrivalTime)
+{
+	/* Measure arrival interval and its deviation. Smoothing is the same as RTP jitter estimation. */
+	if(ArrivalsCount > 0)
+	{
+		const float interval = static_cast<float>(ArrivalTime - LastArrivalTime);
+		if(ArrivalsCount == 1)
+		{
+			ArrivalInterval = interval;
+		}
+		ArrivalDeviation += (FMath::Abs(interval - ArrivalInterval) - ArrivalDeviation) / 16.f;
+		ArrivalInterval += (interval - ArrivalInterval) / 16.f;
+	}
+	LastArrivalTime = ArrivalTime;
+	++ArrivalsCount;
+
+	InsertState(State);
+}
+
+void FVehicleJitterBuffer::SeedState(const FVehiclePhysicsState& State)
+{
+	InsertState(State);
+}
+
+void FVehicleJitterBuffer::InsertState(const FVehiclePhysicsState& State)
+{
+	/* Drop the oldest state if the buffer is full. */
+	if(Buffer.Num() >= MaxBufferSize)
+	{
+#if UE_5_6_OR_LATER
+		Buffer.RemoveAt(0, 1, EAllowShrinking::No);
+#else
+		Buffer.RemoveAt(0, 1, false);
+#endif
+	}
+
+	/* Insert keeping the order, states arriving out of order are rare. */
+	int32 insertIndex = Buffer.Num();
+	while(insertIndex > 0 && Buffer[insertIndex - 1].TimeStamp > State.TimeStamp)
+	{
+		--insertIndex;
+	}
+	Buffer.Insert(State, insertIndex);
+}
+
+float FVehicleJitterBuffer::GetDelay(float MinDelay, float MaxDelay, float DeviationMultiplier) const
+{
+	return FMath::Clamp(ArrivalInterval + ArrivalDeviation * DeviationMultiplier, MinDelay, FMath::Max(MinDelay, MaxDelay));
+}
+
+bool FVehicleJitterBuffer::Sample(double InTime, float MaxExtrapolationTime, FVehiclePhysicsState& OutState, float& OutExtrapolationTime) const
+{
+	OutExtrapolationTime = 0.f;
+	if(Buffer.Num() == 0)
+	{
+		return false;
+	}
+
+	/* Older than anything we have, so take the oldest state. */
+	if(InTime <= Buffer[0].TimeStamp)
+	{
+		OutState = Buffer[0];
+		return true;
+	}
+
+	/* Newer than anything we have, so extrapolate the latest state. */
+	const FVehiclePhysicsState& lastState = Buffer.Last();
+	if(InTime >= lastState.TimeStamp)
+	{
+		OutExtrapolationTime = FMath::Min(static_cast<float>(InTime - lastState.TimeStamp), MaxExtrapolationTime);
+		OutState = lastState;
+		OutState.Location = lastState.Location + lastState.LinearVelocity * OutExtrapolationTime;
+		const FVector angularVelocity = lastState.AngularVelocity;
+		const float angle = FMath::DegreesToRadians(angularVelocity.Size() * OutExtrapolationTime);
+		if(angle > UE_KINDA_SMALL_NUMBER)
+		{
+			OutState.Rotation = (FQuat(angularVelocity.GetSafeNormal(), angle) * lastState.Rotation.Quaternion()).Rotator();
+		}
+		OutState.TimeStamp = lastState.TimeStamp + OutExtrapolationTime;
+		return true;
+	}
+
+	/* Find the states around given time. */
+	int32 endStateIndex = 1;
+	while(Buffer[endStateIndex].TimeStamp < InTime)
+	{
+		++endStateIndex;
+	}
+	const FVehiclePhysicsState& beginState = Buffer[endStateIndex - 1];
+	const FVehiclePhysicsState& endState = Buffer[endStateIndex];
+
+	/* Interpolate using cubic Hermite for location, with tangents made of velocities. The rest is interpolated linearly. */
+	const float span = FMath::Max(static_cast<float>(endState.TimeStamp - beginState.TimeStamp), UE_KINDA_SMALL_NUMBER);
+	const float alpha = static_cast<float>(InTime - beginState.TimeStamp) / span;
+	const FVector beginTangent = beginState.LinearVelocity * span;
+	const FVector endTangent = endState.LinearVelocity * span;
+	OutState = FVehiclePhysicsState::Lerp(beginState, endState, alpha);
+	OutState.Location = FMath::CubicInterp(FVector(beginState.Location), beginTangent, FVector(endState.Location), endTangent, alpha);
+	OutState.LinearVelocity = FMath::CubicInterpDerivative(FVector(beginState.Location), beginTangent, FVector(endState.Location), endTangent, alpha) / span;
+	OutState.TimeStamp = InTime;
+	return true;
+}
+
+void FVehicleJitterBuffer::ClearOldStates(double InTime)
+{
+	/* Keep the latest state older than given time, as it is still needed for interpolation. */
+	int32 countToRemove = 0;
+	while(countToRemove + 1 < Buffer.Num() && Buffer[countToRemove + 1].TimeStamp <= InTime)
+	{
+		++countToRemove;
+	}
+	if(countToRemove > 0)
+	{
+#if UE_5_6_OR_LATER
+		Buffer.RemoveAt(0, countToRemove, EAllowShrinking::No);
+#else
+		Buffer.RemoveAt(0, countToRemove, false);
+#endif
+	}
+}
+
+void FVehicleJitterBuffer::Clear()
+{
+	Buffer.Reset();
+	LastArrivalTime = 0.0;
+	ArrivalInterval = 0.f;
+	ArrivalDeviation = 0.f;
+	ArrivalsCount = 0;
+}
+
+int32 FVehicleJitterBuffer::Num() const
+{
+	return Buffer.Num();
+}
+
+FVehicleInputTimeline::FVehicleInputTimeline()
+	: LastSequence(0)
+	, bHasSequence(false)
+	, PulledSequence(0)
+{
+	PendingInputs.Reserve(MaxPendingInputs * 2);
+	PendingSequences.Reserve(MaxPendingInputs * 2);
+}
+
+int32 FVehicleInputTimeline::Merge(const FVehicleInputHistory& History)
+{
+	if(History.Inputs.Num() == 0)
+	{
+		return 0;
+	}
+
+	/* Very first history only gives us the newest input. */
+	if(!bHasSequence)
+	{
+		PendingInputs.Add(History.Inputs[0]);
+		PendingSequences.Add(History.Sequence);
+		LastSequence = History.Sequence;
+		bHasSequence = true;
+		return 0;
+	}
+
+	/* Sequence wraps around, so the difference is taken as signed. Old or duplicated histories are ignored. */
+	const int16 newInputsCount = static_cast<int16>(History.Sequence - LastSequence);
+	if(newInputsCount <= 0)
+	{
+		return 0;
+	}
+
+	/* Add inputs we haven't seen yet, oldest first. Inputs older than the history are lost for good. */
+	const int32 recoveredCount = FMath::Min<int32>(newInputsCount, History.Inputs.Num());
+	for(int32 i = recoveredCount - 1; i >= 0; --i)
+	{
+		PendingInputs.Add(History.Inputs[i]);
+		PendingSequences.Add(History.Sequence - i);
+	}
+	LastSequence = History.Sequence;
+
+	/* Receiver catches up with the backlog on its own. The oldest inputs are dropped only when nobody consumes them. */
+	const int32 droppedCount = FMath::Max(0, PendingInputs.Num() - MaxBufferedInputs);
+	if(droppedCount > 0)
+	{
+#if UE_5_6_OR_LATER
+		PendingInputs.RemoveAt(0, droppedCount, EAllowShrinking::No);
+		PendingSequences.RemoveAt(0, droppedCount, EAllowShrinking::No);
+#else
+		PendingInputs.RemoveAt(0, droppedCount, false);
+		PendingSequences.RemoveAt(0, droppedCount, false);
+#endif
+	}
+
+	return droppedCount;
+}
+
+bool FVehicleInputTimeline::PullInput(FVehicleInputState& OutInput)
+{
+	if(PendingInputs.Num() == 0)
+	{
+		return false;
+	}
+
+	OutInput = PendingInputs[0];
+	PulledSequence = PendingSequences[0];
+#if UE_5_6_OR_LATER
+	PendingInputs.RemoveAt(0, 1, EAllowShrinking::No);
+	PendingSequences.RemoveAt(0, 1, EAllowShrinking::No);
+#else
+	PendingInputs.RemoveAt(0, 1, false);
+	PendingSequences.RemoveAt(0, 1, false);
+#endif
+	return true;
+}
+
+uint16 FVehicleInputTimeline::GetPulledSequence() const
+{
+	return PulledSequence;
+}
+
+void FVehicleInputTimeline::Clear()
+{
+	PendingInputs.Reset();
+	PendingSequences.Reset();
+	LastSequence = 0;
+	bHasSequence = false;
+}
+
+int32 FVehicleInputTimeline::Num() const
+{
+	return PendingInputs.Num();
+}
+
+FVehiclePredictionFrame::FVehiclePredictionFrame()
+	: Sequence(0)
+	, DeltaTime(0.f)
+	, AdherenceMultiplier(1.f)
+	, RotationMultiplier(1.f)
+	, MovementModifiers(0)
+	, DriveWheelsOnGround(0)
+	, SteeringWheelsOnGround(0)
+{
+}
+
+FVehiclePredictionHistory::FVehiclePredictionHistory()
+{
+	Frames.Reserve(MaxFrames);
+}
+
+void FVehiclePredictionHistory::AddFrame(const FVehiclePredictionFrame& Frame)
+{
+	if(Frames.Num() >= MaxFrames)
+	{
+#if UE_5_6_OR_LATER
+		Frames.RemoveAt(0, Frames.Num() - MaxFrames + 1, EAllowShrinking::No);
+#else
+		Frames.RemoveAt(0, Frames.Num() - MaxFrames + 1, false);
+#endif
+	}
+	Frames.Add(Frame);
+}
+
+int32 FVehiclePredictionHistory::FindFrame(uint16 Sequence) const
+{
+	/* Sequence wraps around, so the offset from the newest frame is taken as signed. */
+	if(Frames.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 index = Frames.Num() - 1 + static_cast<int16>(Sequence - Frames.Last().Sequence);
+	return Frames.IsValidIndex(index) && Frames[index].Sequence == Sequence ? index : INDEX_NONE;
+}
+
+const FVehiclePredictionFrame& FVehiclePredictionHistory::GetFrame(int32 Index) const
+{
+	return Frames[Index];
+}
+
+int32 FVehiclePredictionHistory::Rollback(int32 Index, const FVehiclePhysicsState& CorrectedState, TFunctionRef<void(const FVehiclePredictionFrame& Previous, FVehiclePredictionFrame& Frame)> StepFrame)
+{
+	ClearOldFrames(Index);
+
+	/* Corrected frame takes the server state. Its input and forces stay the predicted ones, the server doesn't send them. */
+	FVehiclePhysicsState& correctedState = Frames[0].State;
+	correctedState.Location = CorrectedState.Location;
+	correctedState.Rotation = CorrectedState.Rotation;
+	correctedState.LinearVelocity = CorrectedState.LinearVelocity;
+	correctedState.AngularVelocity = CorrectedState.AngularVelocity;
+
+	/* Re-simulate newer frames one by one, so the history stays corrected for the next comparison. */
+	for(int32 i = 1; i < Frames.Num(); ++i)
+	{
+		StepFrame(Frames[i - 1], Frames[i]);
+	}
+
+	return Frames.Num() - 1;
+}
+
+void FVehiclePredictionHistory::ClearOldFrames(int32 Index)
+{
+	if(Index > 0)
+	{
+#if UE_5_6_OR_LATER
+		Frames.RemoveAt(0, FMath::Min(Index, Frames.Num()), EAllowShrinking::No);
+#else
+		Frames.RemoveAt(0, FMath::Min(Index, Frames.Num()), false);
+#endif
+	}
+}
+
+void FVehiclePredictionHistory::Clear()
+{
+	Frames.Reset();
+}
+
+int32 FVehiclePredictionHistory::Num() const
+{
+	return Frames.Num();
+}
+
 FVehicleForces::FVehicleForces()
 	: Braking(0.f)
 	, EngineBraking(0.f)
@@ -294,3 +728,307 @@ FVehicleInputState FVehicleInputState::Lerp(const FVehicleInputState& A, const F
 	}
 	return lerpState;
 }
+
+bool FVehicleInputState::Equals(const FVehicleInputState& Other) const
+{
+	return AccelerationInput == Other.AccelerationInput.ToFloat()
+		&& TurningInput == Other.TurningInput.ToFloat()
+		&& CustomInput == Other.CustomInput.ToFloat()
+		&& CustomBitflags == Other.CustomBitflags
+		&& InternalBitflags == Other.InternalBitflags;
+}
+
+void FVehicleInputState::SerializeCompact(FArchive& Ar)
+{
+	bool bSuccess = true;
+	AccelerationInput.NetSerialize(Ar, nullptr, bSuccess);
+	TurningInput.NetSerialize(Ar, nullptr, bSuccess);
+	CustomInput.NetSerialize(Ar, nullptr, bSuccess);
+	Ar << CustomBitflags;
+	Ar << InternalBitflags;
+}
+
+void FVehicleInputState::Quantize()
+{
+	AccelerationInput.Quantize();
+	TurningInput.Quantize();
+	CustomInput.Quantize();
+}
+
+FVehicleNetTelemetry::FVehicleNetTelemetry()
+{
+	Reset();
+}
+
+float FVehicleNetTelemetry::GetCorrectionBucketLimit(int32 Bucket)
+{
+	static const float bucketLimits[NumCorrectionBuckets] = { 1.f, 2.f, 5.f, 10.f, 25.f, 50.f, 100.f, TNumericLimits<float>::Max() };
+	return bucketLimits[FMath::Clamp(Bucket, 0, NumCorrectionBuckets - 1)];
+}
+
+bool FVehicleNetTelemetry::IsEnabled()
+{
+#if STATS || CSV_PROFILER
+	return ArcadeVehicleNetworkHelpers::CVarNetTelemetry.GetValueOnGameThread();
+#else
+	return false;
+#endif
+}
+
+int32 FVehicleNetTelemetry::GetSerializedBytes(const FVehiclePhysicsState& State)
+{
+	if(!IsEnabled())
+	{
+		return 0;
+	}
+
+	/* Properties are serialized the same way the replication does, so packing of the actual values is counted. */
+	return ArcadeVehicleNetworkHelpers::GetSerializedBytes([&State](FArchive& Ar)
+	{
+		bool bSuccess = true;
+		FVehiclePhysicsState state = State;
+		uint8 movementModifiers = state.GetMovementModifiers();
+		state.TimeStamp.NetSerialize(Ar, nullptr, bSuccess);
+		state.Input.SerializeCompact(Ar);
+		state.Location.NetSerialize(Ar, nullptr, bSuccess);
+		state.Rotation.SerializeCompressedShort(Ar);
+		state.LinearVelocity.NetSerialize(Ar, nullptr, bSuccess);
+		state.AngularVelocity.NetSerialize(Ar, nullptr, bSuccess);
+		Ar << movementModifiers;
+	});
+}
+
+int32 FVehicleNetTelemetry::GetSerializedBytes(const FVehicleInputFrame& Frame)
+{
+	if(!IsEnabled())
+	{
+		return 0;
+	}
+
+	return ArcadeVehicleNetworkHelpers::GetSerializedBytes([&Frame](FArchive& Ar)
+	{
+		bool bSuccess = true;
+		FVehicleInputFrame frame = Frame;
+		frame.TimeStamp.NetSerialize(Ar, nullptr, bSuccess);
+		frame.Input.SerializeCompact(Ar);
+		Ar << frame.MovementModifiers;
+	});
+}
+
+int32 FVehicleNetTelemetry::GetSerializedBytes(const FVehicleInputHistory& History)
+{
+	if(!IsEnabled())
+	{
+		return 0;
+	}
+
+	/* Saving doesn't modify the history, so it isn't copied just to be counted. */
+	return ArcadeVehicleNetworkHelpers::GetSerializedBytes([&History](FArchive& Ar)
+	{
+		bool bSuccess = true;
+		const_cast<FVehicleInputHistory&>(History).NetSerialize(Ar, nullptr, bSuccess);
+	});
+}
+
+void FVehicleNetTelemetry::Reset()
+{
+	FMemory::Memzero(CorrectionHistogram);
+	CorrectionsCount = 0;
+	LocationErrorSum = 0.f;
+	LocationErrorMax = 0.f;
+	RotationErrorSum = 0.f;
+	RotationErrorMax = 0.f;
+	VelocityErrorSum = 0.f;
+	VelocityErrorMax = 0.f;
+	LocationSnaps = 0;
+	RotationSnaps = 0;
+	BytesSent = 0;
+	BytesReceived = 0;
+	StatesReceived = 0;
+	BufferOccupancySum = 0;
+	BufferOccupancyMax = 0;
+	BufferSamples = 0;
+	SimulationTime = 0.0;
+	SimulationTicks = 0;
+	bIsInterpolating = false;
+	InterpolationDelay = 0.f;
+	ExtrapolatedFrames = 0;
+	RollbacksCount = 0;
+	RollbackFramesSum = 0;
+	RollbackFramesMax = 0;
+	RollbackTimeSum = 0.0;
+	RollbackTimeMax = 0.0;
+	DroppedInputs = 0;
+	StartTime = FPlatformTime::Seconds();
+}
+
+void FVehicleNetTelemetry::AddCorrection(float LocationError, float RotationError, float VelocityError)
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	int32 bucket = 0;
+	while(bucket < NumCorrectionBuckets - 1 && LocationError > GetCorrectionBucketLimit(bucket))
+	{
+		++bucket;
+	}
+	++CorrectionHistogram[bucket];
+	++CorrectionsCount;
+
+	LocationErrorSum += LocationError;
+	LocationErrorMax = FMath::Max(LocationErrorMax, LocationError);
+	RotationErrorSum += RotationError;
+	RotationErrorMax = FMath::Max(RotationErrorMax, RotationError);
+	VelocityErrorSum += VelocityError;
+	VelocityErrorMax = FMath::Max(VelocityErrorMax, VelocityError);
+
+	INC_FLOAT_STAT_BY(STAT_ArcadeVehicleNet_LocationError, LocationError);
+	INC_FLOAT_STAT_BY(STAT_ArcadeVehicleNet_RotationError, RotationError);
+	INC_FLOAT_STAT_BY(STAT_ArcadeVehicleNet_VelocityError, VelocityError);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, LocationError, LocationError, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, RotationError, RotationError, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, VelocityError, VelocityError, ECsvCustomStatOp::Max);
+}
+
+void FVehicleNetTelemetry::AddLocationSnap()
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	++LocationSnaps;
+	INC_DWORD_STAT(STAT_ArcadeVehicleNet_LocationSnaps);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, LocationSnaps, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void FVehicleNetTelemetry::AddRotationSnap()
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	++RotationSnaps;
+	INC_DWORD_STAT(STAT_ArcadeVehicleNet_RotationSnaps);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, RotationSnaps, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void FVehicleNetTelemetry::AddBytesSent(int32 Bytes)
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	BytesSent += Bytes;
+	INC_DWORD_STAT_BY(STAT_ArcadeVehicleNet_BytesSent, Bytes);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, BytesSent, Bytes, ECsvCustomStatOp::Accumulate);
+}
+
+void FVehicleNetTelemetry::AddBytesReceived(int32 Bytes)
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	BytesReceived += Bytes;
+	INC_DWORD_STAT_BY(STAT_ArcadeVehicleNet_BytesReceived, Bytes);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, BytesReceived, Bytes, ECsvCustomStatOp::Accumulate);
+}
+
+void FVehicleNetTelemetry::AddStateReceived()
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	++StatesReceived;
+	INC_DWORD_STAT(STAT_ArcadeVehicleNet_StatesReceived);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, StatesReceived, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void FVehicleNetTelemetry::AddBufferSample(int32 Occupancy)
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	BufferOccupancySum += Occupancy;
+	BufferOccupancyMax = FMath::Max(BufferOccupancyMax, Occupancy);
+	++BufferSamples;
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, BufferOccupancy, Occupancy, ECsvCustomStatOp::Max);
+}
+
+void FVehicleNetTelemetry::AddSimulationTime(double Seconds, bool bNewTick)
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	SimulationTime += Seconds;
+	if(bNewTick)
+	{
+		++SimulationTicks;
+	}
+}
+
+void FVehicleNetTelemetry::AddInterpolationSample(float Delay, float ExtrapolationTime)
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	bIsInterpolating = true;
+	InterpolationDelay = Delay;
+	if(ExtrapolationTime > 0.f)
+	{
+		++ExtrapolatedFrames;
+	}
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, InterpolationDelay, Delay * 1000.f, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, ExtrapolatedFrames, ExtrapolationTime > 0.f ? 1 : 0, ECsvCustomStatOp::Accumulate);
+}
+
+void FVehicleNetTelemetry::AddRollback(int32 Frames, double Seconds)
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	++RollbacksCount;
+	RollbackFramesSum += Frames;
+	RollbackFramesMax = FMath::Max(RollbackFramesMax, Frames);
+	RollbackTimeSum += Seconds;
+	RollbackTimeMax = FMath::Max(RollbackTimeMax, Seconds);
+
+	INC_DWORD_STAT(STAT_ArcadeVehicleNet_Rollbacks);
+	INC_DWORD_STAT_BY(STAT_ArcadeVehicleNet_ResimulatedFrames, Frames);
+	INC_FLOAT_STAT_BY(STAT_ArcadeVehicleNet_ResimulationTime, static_cast<float>(Seconds * 1000.0));
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, ResimulatedFrames, Frames, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, ResimulationTime, static_cast<float>(Seconds * 1000.0), ECsvCustomStatOp::Max);
+}
+
+void FVehicleNetTelemetry::AddDroppedInputs(int32 Count)
+{
+	if(!IsEnabled())
+	{
+		return;
+	}
+
+	DroppedInputs += Count;
+	CSV_CUSTOM_STAT(ArcadeVehicleNet, DroppedInputs, Count, ECsvCustomStatOp::Accumulate);
+}
+
+float FVehicleNetTelemetry::GetStatesPerSecond() const
+{
+	const double duration = FPlatformTime::Seconds() - StartTime;
+	return duration > 0.0 ? static_cast<float>(StatesReceived / duration) : 0.f;
+}
@@ -0,0 +1,460 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#include "Networking/ArcadeVehicleReplicationGraph.h"
+#include "Movement/ArcadeVehicleMovementComponentBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/NetDriver.h"
+#include "Engine/ChildConnection.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace ArcadeVehicleReplicationGraph
+{
+	/** Runs the benchmark for given number of connections. */
+	static void RunBenchmark(const UWorld* World, int32 Connections, int32 Frames)
+	{
+		const UNetDriver* pNetDriver = World ? World->GetNetDriver() : nullptr;
+		const UArcadeVehicleReplicationGraph* pGraph = IsValid(pNetDriver) ? Cast<UArcadeVehicleReplicationGraph>(pNetDriver->GetReplicationDriver()) : nullptr;
+		if(!IsValid(pGraph))
+		{
+			UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("Replication graph benchmark needs to be run on the server using arcade vehicle replication graph."));
+			return;
+		}
+		pGraph->RunBenchmark(Connections, Frames);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("avs.RepGraph.Benchmark"),
+		TEXT("Gathers competitors of synthetic connections on the registered vehicles and logs the timings. Runs 64 and 128 connections if no count is given. Arguments: [Connections] [Frames]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			const int32 frames = Args.IsValidIndex(1) ? FMath::Max(1, FCString::Atoi(*Args[1])) : 100;
+			if(Args.IsValidIndex(0))
+			{
+				RunBenchmark(World, FMath::Max(1, FCString::Atoi(*Args[0])), frames);
+			}
+			else
+			{
+				RunBenchmark(World, 64, frames);
+				RunBenchmark(World, 128, frames);
+			}
+		}));
+}
+
+FArcadeVehicleReplicationBucket::FArcadeVehicleReplicationBucket()
+	: MaxDistance(0.f)
+	, ReplicationPeriodFrame(1)
+{
+}
+
+FArcadeVehicleReplicationBucket::FArcadeVehicleReplicationBucket(float InMaxDistance, int32 InReplicationPeriodFrame)
+	: MaxDistance(InMaxDistance)
+	, ReplicationPeriodFrame(InReplicationPeriodFrame)
+{
+}
+
+void UReplicationGraphNode_ArcadeVehicleCompetitors::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ArcadeVehicleCompetitors_Gather);
+
+	ReplicationActorList.Reset();
+	if(!IsValid(OwningGraph))
+	{
+		return;
+	}
+
+	TArray<FArcadeVehicleCompetitor, TInlineAllocator<128>> competitors;
+	OwningGraph->GatherCompetitors(Params.Viewers, competitors);
+
+	/* Assign replication frequency of the vehicles for this connection. */
+	for(const FArcadeVehicleCompetitor& competitor : competitors)
+	{
+		FConnectionReplicationActorInfo& connectionInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(competitor.Actor);
+		connectionInfo.ReplicationPeriodFrame = competitor.ReplicationPeriodFrame;
+	}
+
+	/* Nearest competitors are always relevant. */
+	const int32 competitorsCount = FMath::Min(OwningGraph->GetNearestCompetitorsCount(), competitors.Num());
+	if(competitorsCount <= 0)
+	{
+		return;
+	}
+	for(int32 i = 0; i < competitorsCount; ++i)
+	{
+		ReplicationActorList.Add(competitors[i].Actor);
+	}
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+}
+
+void UReplicationGraphNode_ArcadeVehicleAlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	Super::GatherActorListsForConnection(Params);
+
+	/* Viewer, its pawn and its view target are always relevant for its own connection. */
+	ViewerActorList.Reset();
+	for(const FNetViewer& viewer : Params.Viewers)
+	{
+		if(IsValid(viewer.InViewer))
+		{
+			ViewerActorList.Add(viewer.InViewer);
+			if(const APlayerController* pPlayerController = Cast<APlayerController>(viewer.InViewer))
+			{
+				if(IsValid(pPlayerController->GetPawn()))
+				{
+					ViewerActorList.Add(pPlayerController->GetPawn());
+				}
+			}
+		}
+		if(IsValid(viewer.ViewTarget) && viewer.ViewTarget != viewer.InViewer)
+		{
+			ViewerActorList.Add(viewer.ViewTarget);
+		}
+	}
+	if(ViewerActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(ViewerActorList);
+	}
+}
+
+UReplicationGraphNode_ArcadeVehicleOwnerOnly::UReplicationGraphNode_ArcadeVehicleOwnerOnly()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UReplicationGraphNode_ArcadeVehicleOwnerOnly::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Actors.Add(ActorInfo.Actor);
+}
+
+bool UReplicationGraphNode_ArcadeVehicleOwnerOnly::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	const bool bRemoved = Actors.RemoveFast(ActorInfo.Actor);
+	if(!bRemoved && bWarnIfNotFound)
+	{
+		UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("Owner only actor %s was not found in the replication graph."), *GetNameSafe(ActorInfo.Actor));
+	}
+
+	/* Drop it from the groups as well, they are rebuilt only on the next frame. */
+	for(TPair<UNetConnection*, FActorRepListRefView>& connectionActors : ConnectionActors)
+	{
+		connectionActors.Value.RemoveFast(ActorInfo.Actor);
+	}
+	return bRemoved;
+}
+
+void UReplicationGraphNode_ArcadeVehicleOwnerOnly::NotifyResetAllNetworkActors()
+{
+	Actors.Reset();
+	ConnectionActors.Reset();
+}
+
+void UReplicationGraphNode_ArcadeVehicleOwnerOnly::PrepareForReplication()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ArcadeVehicleOwnerOnly_Prepare);
+
+	/* Group the actors by their owning connection. Split screen players share connection of their parent. */
+	for(TPair<UNetConnection*, FActorRepListRefView>& connectionActors : ConnectionActors)
+	{
+		connectionActors.Value.Reset();
+	}
+	for(FActorRepListType pActor : Actors)
+	{
+		UNetConnection* pConnection = pActor->GetNetConnection();
+		if(pConnection == nullptr)
+		{
+			continue;
+		}
+		if(UChildConnection* pChildConnection = pConnection->GetUChildConnection())
+		{
+			pConnection = pChildConnection->Parent;
+		}
+		ConnectionActors.FindOrAdd(pConnection).Add(pActor);
+	}
+
+	/* Forget connections that don't own anything anymore, closed ones included. */
+	for(auto it = ConnectionActors.CreateIterator(); it; ++it)
+	{
+		if(it->Value.Num() == 0)
+		{
+			it.RemoveCurrent();
+		}
+	}
+}
+
+void UReplicationGraphNode_ArcadeVehicleOwnerOnly::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	if(const FActorRepListRefView* pConnectionActors = ConnectionActors.Find(Params.ConnectionManager.NetConnection))
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(*pConnectionActors);
+	}
+}
+
+UArcadeVehicleReplicationGraph::UArcadeVehicleReplicationGraph()
+{
+	GridCellSize = 10000.f;
+	GridSpatialBias = FVector2D(-200000.f, -200000.f);
+	VehicleCullDistance = 30000.f;
+	NearestCompetitorsCount = 4;
+	FrequencyBuckets.Emplace(5000.f, 1);
+	FrequencyBuckets.Emplace(15000.f, 2);
+	FrequencyBuckets.Emplace(30000.f, 4);
+	FastVehicleSpeed = 150.f;
+	SlowVehicleSpeed = 5.f;
+	GridNode = nullptr;
+	AlwaysRelevantNode = nullptr;
+	OwnerOnlyNode = nullptr;
+}
+
+void UArcadeVehicleReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	/* Default settings for all actors. All classes inherit them from here. */
+	FClassReplicationInfo actorInfo;
+	actorInfo.SetCullDistanceSquared(GetDefault<AActor>()->GetNetCullDistanceSquared());
+	GlobalActorReplicationInfoMap.SetClassInfo(AActor::StaticClass(), actorInfo);
+
+	/* Pawns, so the vehicles, use vehicle cull distance. */
+	FClassReplicationInfo pawnInfo;
+	pawnInfo.SetCullDistanceSquared(FMath::Square(VehicleCullDistance));
+	GlobalActorReplicationInfoMap.SetClassInfo(APawn::StaticClass(), pawnInfo);
+}
+
+void UArcadeVehicleReplicationGraph::InitGlobalGraphNodes()
+{
+	/* Spatialization grid for everything that moves or lives somewhere in the world. */
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = GridSpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	/* Actors relevant for everyone. */
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	/* Actors relevant only to their owner, gathered for the owning connection. */
+	OwnerOnlyNode = CreateNewNode<UReplicationGraphNode_ArcadeVehicleOwnerOnly>();
+	AddGlobalGraphNode(OwnerOnlyNode);
+}
+
+void UArcadeVehicleReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	/* Viewer related actors. */
+	UReplicationGraphNode_ArcadeVehicleAlwaysRelevant_ForConnection* pAlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ArcadeVehicleAlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(pAlwaysRelevantNode, RepGraphConnection);
+
+	/* Nearest race competitors and vehicles replication frequency. */
+	UReplicationGraphNode_ArcadeVehicleCompetitors* pCompetitorsNode = CreateNewNode<UReplicationGraphNode_ArcadeVehicleCompetitors>();
+	pCompetitorsNode->OwningGraph = this;
+	AddConnectionGraphNode(pCompetitorsNode, RepGraphConnection);
+}
+
+void UArcadeVehicleReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	AActor* pActor = ActorInfo.Actor;
+
+	/* Always relevant actors go to the global list. */
+	if(pActor->bAlwaysRelevant)
+	{
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		return;
+	}
+
+	/* Owner only actors are gathered for their owning connection. */
+	if(pActor->bOnlyRelevantToOwner)
+	{
+		OwnerOnlyNode->NotifyAddNetworkActor(ActorInfo);
+		return;
+	}
+
+	/* Register arcade vehicles. They can go dormant, so they use dormancy aware grid list. */
+	UArcadeVehicleMovementComponentBase* pMovement = pActor->FindComponentByClass<UArcadeVehicleMovementComponentBase>();
+	if(IsValid(pMovement))
+	{
+		FArcadeVehicleReplicationInfo& vehicle = Vehicles.AddDefaulted_GetRef();
+		vehicle.Actor = pActor;
+		vehicle.MovementComponent = pMovement;
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		return;
+	}
+
+	/* Everything else is spatialized. */
+	if(pActor->IsNetStartupActor() && !pActor->IsRootComponentMovable())
+	{
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+	}
+	else
+	{
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+	}
+}
+
+void UArcadeVehicleReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	AActor* pActor = ActorInfo.Actor;
+
+	if(pActor->bAlwaysRelevant)
+	{
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		return;
+	}
+
+	if(pActor->bOnlyRelevantToOwner)
+	{
+		OwnerOnlyNode->NotifyRemoveNetworkActor(ActorInfo);
+		return;
+	}
+
+	/* Prune entries of vehicles that are already gone, they don't tell anything about this actor. */
+	Vehicles.RemoveAllSwap([](const FArcadeVehicleReplicationInfo& Vehicle)
+	{
+		return !Vehicle.Actor.IsValid();
+	});
+
+	/* Unregister arcade vehicles. */
+	const int32 removedVehicles = Vehicles.RemoveAllSwap([pActor](const FArcadeVehicleReplicationInfo& Vehicle)
+	{
+		return Vehicle.Actor.Get() == pActor;
+	});
+	if(removedVehicles > 0)
+	{
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		return;
+	}
+
+	if(pActor->IsNetStartupActor() && !pActor->IsRootComponentMovable())
+	{
+		GridNode->RemoveActor_Static(ActorInfo);
+	}
+	else
+	{
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+	}
+}
+
+const TArray<FArcadeVehicleReplicationInfo>& UArcadeVehicleReplicationGraph::GetVehicles() const
+{
+	return Vehicles;
+}
+
+int32 UArcadeVehicleReplicationGraph::GetNearestCompetitorsCount() const
+{
+	return NearestCompetitorsCount;
+}
+
+int32 UArcadeVehicleReplicationGraph::GetVehicleReplicationPeriod(float Distance, float Speed) const
+{
+	/* Find the distance bucket. Vehicles further than the last bucket replicate twice as rare as it. */
+	int32 period = FrequencyBuckets.Num() > 0 ? FrequencyBuckets.Last().ReplicationPeriodFrame * 2 : 1;
+	for(const FArcadeVehicleReplicationBucket& bucket : FrequencyBuckets)
+	{
+		if(Distance <= bucket.MaxDistance)
+		{
+			period = bucket.ReplicationPeriodFrame;
+			break;
+		}
+	}
+
+	/* Fast vehicles need updates more often, while resting ones can wait. */
+	if(Speed >= FastVehicleSpeed)
+	{
+		period /= 2;
+	}
+	else if(Speed <= SlowVehicleSpeed)
+	{
+		period *= 2;
+	}
+
+	return FMath::Clamp(period, 1, static_cast<int32>(MAX_uint16));
+}
+
+void UArcadeVehicleReplicationGraph::GatherCompetitors(TArrayView<const FNetViewer> Viewers, TArray<FArcadeVehicleCompetitor, TInlineAllocator<128>>& OutCompetitors) const
+{
+	OutCompetitors.Reset();
+
+	/* Run through all vehicles. */
+	for(const FArcadeVehicleReplicationInfo& vehicle : Vehicles)
+	{
+		AActor* pActor = vehicle.Actor.Get();
+		const UArcadeVehicleMovementComponentBase* pMovement = vehicle.MovementComponent.Get();
+		if(!IsValid(pActor) || !IsValid(pMovement))
+		{
+			continue;
+		}
+
+		/* Find the closest viewer. Vehicle viewed by the connection itself is not its competitor. */
+		float distanceSquared = TNumericLimits<float>::Max();
+		bool bIsViewedVehicle = false;
+		for(const FNetViewer& viewer : Viewers)
+		{
+			if(viewer.ViewTarget == pActor)
+			{
+				bIsViewedVehicle = true;
+				break;
+			}
+			distanceSquared = FMath::Min(distanceSquared, static_cast<float>(FVector::DistSquared(viewer.ViewLocation, pActor->GetActorLocation())));
+		}
+		if(bIsViewedVehicle)
+		{
+			continue;
+		}
+
+		/* Replication frequency for the connection uses distance and speed from the replicated state. */
+		const float speed = pMovement->GetReplicatedState().LinearVelocity.Size() * KMH_MULTIPLIER;
+		FArcadeVehicleCompetitor& competitor = OutCompetitors.AddDefaulted_GetRef();
+		competitor.DistanceSquared = distanceSquared;
+		competitor.Actor = pActor;
+		competitor.ReplicationPeriodFrame = GetVehicleReplicationPeriod(FMath::Sqrt(distanceSquared), speed);
+	}
+
+	/* Sort by distance to the closest viewer, only nearest competitors need it. */
+	if(NearestCompetitorsCount > 0)
+	{
+		OutCompetitors.Sort([](const FArcadeVehicleCompetitor& A, const FArcadeVehicleCompetitor& B)
+		{
+			return A.DistanceSquared < B.DistanceSquared;
+		});
+	}
+}
+
+void UArcadeVehicleReplicationGraph::RunBenchmark(int32 Connections, int32 Frames) const
+{
+	/* Viewers of the vehicles that are still alive. */
+	TArray<FNetViewer> viewers;
+	for(const FArcadeVehicleReplicationInfo& vehicle : Vehicles)
+	{
+		if(AActor* pActor = vehicle.Actor.Get())
+		{
+			FNetViewer& viewer = viewers.AddDefaulted_GetRef();
+			viewer.ViewTarget = pActor;
+			viewer.ViewLocation = pActor->GetActorLocation();
+		}
+	}
+	if(viewers.Num() == 0)
+	{
+		UE_LOG(LogArcadeVehicleMovement, Warning, TEXT("Replication graph benchmark needs at least one registered vehicle."));
+		return;
+	}
+
+	/* Each synthetic connection views one of the vehicles, round robin. */
+	TArray<FArcadeVehicleCompetitor, TInlineAllocator<128>> competitors;
+	int32 gatheredCompetitors = 0;
+	const double startTime = FPlatformTime::Seconds();
+	for(int32 frame = 0; frame < Frames; ++frame)
+	{
+		for(int32 connection = 0; connection < Connections; ++connection)
+		{
+			GatherCompetitors(MakeArrayView(&viewers[connection % viewers.Num()], 1), competitors);
+			gatheredCompetitors += competitors.Num();
+		}
+	}
+	const double elapsedTime = FPlatformTime::Seconds() - startTime;
+
+	const double toMicroseconds = 1000000.0 / Frames;
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("Replication graph benchmark: %d connections, %d vehicles, %d frames, %.1f competitors per connection."),
+		Connections, viewers.Num(), Frames, static_cast<double>(gatheredCompetitors) / (static_cast<double>(Frames) * Connections));
+	UE_LOG(LogArcadeVehicleMovement, Log, TEXT("  %.2fus per frame, %.2fus per connection"), elapsedTime * toMicroseconds, elapsedTime * toMicroseconds / Connections);
+}
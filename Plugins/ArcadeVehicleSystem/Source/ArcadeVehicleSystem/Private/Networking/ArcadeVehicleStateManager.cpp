@@ -0,0 +1,186 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#include "Networking/ArcadeVehicleStateManager.h"
+#include "Movement/ArcadeVehicleMovementComponentBase.h"
+#include "Networking/ArcadeVehicleClockSyncComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+FVehicleStateItem::FVehicleStateItem()
+{
+	Vehicle = nullptr;
+}
+
+void FVehicleStateItem::PostReplicatedAdd(const FVehicleStateArray& InArraySerializer)
+{
+	PostReplicatedChange(InArraySerializer);
+}
+
+void FVehicleStateItem::PostReplicatedChange(const FVehicleStateArray& InArraySerializer)
+{
+	/* Vehicle might not be resolved yet. It will receive the next state once it is. */
+	if(IsValid(Vehicle))
+	{
+		Vehicle->ReceiveBatchedState(State);
+	}
+}
+
+FVehicleGridSlot::FVehicleGridSlot()
+{
+	Vehicle = nullptr;
+	Location = FVector::ZeroVector;
+	Rotation = FRotator::ZeroRotator;
+}
+
+AArcadeVehicleStateManager::AArcadeVehicleStateManager()
+{
+	/* Ticks only while grid placements are pending. */
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	/* Manager has to replicate to everyone, as often as the vehicles would. */
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	SetNetUpdateFrequency(100.f);
+	NetPriority = 3.f;
+}
+
+void AArcadeVehicleStateManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	/* Apply placements whose time has come, in the order they were sent. */
+	const double time = GetWorld()->GetTimeSeconds();
+	while(PendingPlacements.Num() > 0 && PendingPlacements[0].Key <= time)
+	{
+		ApplyPlacement(PendingPlacements[0].Value);
+		PendingPlacements.RemoveAt(0);
+	}
+
+	if(PendingPlacements.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void AArcadeVehicleStateManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AArcadeVehicleStateManager, VehicleStates);
+}
+
+AArcadeVehicleStateManager* AArcadeVehicleStateManager::Get(UWorld* World)
+{
+	if(!IsValid(World))
+	{
+		return nullptr;
+	}
+
+	/* Find already existing manager. */
+	for(TActorIterator<AArcadeVehicleStateManager> it(World); it; ++it)
+	{
+		return *it;
+	}
+
+	/* Only the server can spawn the manager, clients receive it through replication. */
+	if(World->GetNetMode() == NM_Client)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters spawnParameters;
+	spawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AArcadeVehicleStateManager>(spawnParameters);
+}
+
+void AArcadeVehicleStateManager::UpdateVehicleState(UArcadeVehicleMovementComponentBase* Vehicle, const FVehiclePhysicsState& State)
+{
+	/* Update already registered vehicle. */
+	if(const int32* pIndex = VehicleIndices.Find(Vehicle))
+	{
+		FVehicleStateItem& item = VehicleStates.Items[*pIndex];
+		item.State = State;
+		VehicleStates.MarkItemDirty(item);
+		return;
+	}
+
+	/* Register new vehicle. */
+	VehicleIndices.Add(Vehicle, VehicleStates.Items.Num());
+	FVehicleStateItem& newItem = VehicleStates.Items.AddDefaulted_GetRef();
+	newItem.Vehicle = Vehicle;
+	newItem.State = State;
+	VehicleStates.MarkItemDirty(newItem);
+}
+
+void AArcadeVehicleStateManager::UnregisterVehicle(UArcadeVehicleMovementComponentBase* Vehicle)
+{
+	int32 index = INDEX_NONE;
+	if(!VehicleIndices.RemoveAndCopyValue(Vehicle, index))
+	{
+		return;
+	}
+
+	/* Fast array items are identified by their replication id, so the last item can take place of the removed one. */
+#if UE_5_6_OR_LATER
+	VehicleStates.Items.RemoveAtSwap(index, 1, EAllowShrinking::No);
+#else
+	VehicleStates.Items.RemoveAtSwap(index, 1, false);
+#endif
+	if(VehicleStates.Items.IsValidIndex(index))
+	{
+		VehicleIndices.Add(VehicleStates.Items[index].Vehicle, index);
+	}
+	VehicleStates.MarkArrayDirty();
+}
+
+void AArcadeVehicleStateManager::PlaceVehicles(const TArray<UArcadeVehicleMovementComponentBase*>& Vehicles, const TArray<FTransform>& Transforms, float Delay)
+{
+	if(Vehicles.Num() != Transforms.Num())
+	{
+		UE_LOG(LogArcadeVehicleMovement, Error, TEXT("PlaceVehicles method requires single transform per vehicle!"));
+		return;
+	}
+
+	FVehicleGridPlacement placement;
+	placement.ApplyTime = GetWorld()->GetTimeSeconds() + FMath::Max(Delay, 0.f);
+	placement.Slots.Reserve(Vehicles.Num());
+	for(int32 i = 0; i < Vehicles.Num(); ++i)
+	{
+		if(!IsValid(Vehicles[i]))
+		{
+			continue;
+		}
+
+		/* States of the vehicles have to reach the clients again after the teleport. */
+		Vehicles[i]->WakeFromNetDormancy();
+
+		FVehicleGridSlot& slot = placement.Slots.AddDefaulted_GetRef();
+		slot.Vehicle = Vehicles[i];
+		slot.Location = Transforms[i].GetLocation();
+		slot.Rotation = Transforms[i].Rotator();
+	}
+
+	OnReceivePlacement_Multicast(placement);
+}
+
+void AArcadeVehicleStateManager::OnReceivePlacement_Multicast_Implementation(const FVehicleGridPlacement& Placement)
+{
+	/* Convert server time of the placement to the local time. Until the clock is synchronized, it is estimated from the replicated server time and half RTT. */
+	const double localApplyTime = UArcadeVehicleClockSyncComponent::ServerToLocalTime(GetWorld(), Placement.ApplyTime.ToSeconds());
+	PendingPlacements.Emplace(localApplyTime, Placement);
+	SetActorTickEnabled(true);
+}
+
+void AArcadeVehicleStateManager::ApplyPlacement(const FVehicleGridPlacement& Placement)
+{
+	for(const FVehicleGridSlot& slot : Placement.Slots)
+	{
+		/* Vehicle might not be resolved on this client yet. It will receive its teleported state once it is. */
+		if(IsValid(slot.Vehicle))
+		{
+			slot.Vehicle->ApplyTeleport(slot.Location, slot.Rotation);
+		}
+	}
+}
@@ -0,0 +1,200 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#include "Networking/ArcadeVehicleStateValidation.h"
+#include "Movement/ArcadeVehicleMovementComponentBase.h"
+#include "Settings/ArcadeVehicleSettings.h"
+#include "Curves/CurveFloat.h"
+#include "HAL/IConsoleManager.h"
+#include "Tasks/Task.h"
+#include <atomic>
+
+namespace ArcadeVehicleStateValidation
+{
+	/** Step of the forward speed re-simulation, in seconds. */
+	static constexpr float ResimulationStep = 1.f / 60.f;
+
+	/** States further apart than this, in seconds, only get speed checked. Gaps like that come from packet loss or hitches. */
+	static constexpr float MaxValidatedDeltaTime = 0.5f;
+
+	/** Absolute slack added to the continuity check, in world units, covering quantization and collision pushes. */
+	static constexpr float ContinuitySlack = 50.f;
+
+	/** Absolute slack added to the speed checks, in km/h. */
+	static constexpr float SpeedSlack = 5.f;
+
+	/** Throughput counters, updated by the worker threads. */
+	static std::atomic<int64> ValidationsCount(0);
+	static std::atomic<int64> RejectionsCount(0);
+	static std::atomic<uint64> ValidationCycles(0);
+	static double CountersStartTime = FPlatformTime::Seconds();
+
+	/** Bakes curve into evenly spaced samples. Missing curve bakes into zeros. */
+	static void BakeCurve(const UCurveFloat* Curve, float Range, TArray<float>& OutSamples)
+	{
+		OutSamples.SetNumZeroed(FVehicleValidationLimits::CurveSamples);
+		if(!IsValid(Curve))
+		{
+			return;
+		}
+
+		for(int32 i = 0; i < FVehicleValidationLimits::CurveSamples; ++i)
+		{
+			OutSamples[i] = Curve->GetFloatValue(Range * i / (FVehicleValidationLimits::CurveSamples - 1));
+		}
+	}
+
+	void LaunchValidation(FVehicleValidationJob&& Job, const TSharedRef<FVehicleValidationResultQueue, ESPMode::ThreadSafe>& Results)
+	{
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job = MoveTemp(Job), Results]()
+		{
+			const uint64 startCycles = FPlatformTime::Cycles64();
+			FVehicleValidationResult result;
+			result.Verdict = Job.Validate();
+			result.TimeStamp = Job.State.TimeStamp;
+			Results->Enqueue(result);
+
+			ValidationCycles += FPlatformTime::Cycles64() - startCycles;
+			++ValidationsCount;
+			if(result.Verdict != VehicleStateVerdict::Valid)
+			{
+				++RejectionsCount;
+			}
+		});
+	}
+
+	static FAutoConsoleCommand ValidationStatsCommand(
+		TEXT("avs.Net.ValidationStats"),
+		TEXT("Logs throughput of the server-side state validation since the previous call, and resets the counters."),
+		FConsoleCommandDelegate::CreateStatic([]()
+		{
+			const double time = FPlatformTime::Seconds();
+			const int64 validations = ValidationsCount.exchange(0);
+			const int64 rejections = RejectionsCount.exchange(0);
+			const uint64 cycles = ValidationCycles.exchange(0);
+			const double elapsed = FMath::Max(time - CountersStartTime, UE_DOUBLE_SMALL_NUMBER);
+			CountersStartTime = time;
+
+			UE_LOG(LogArcadeVehicleMovement, Log, TEXT("State validation: %lld validations in %.2fs (%.1f/s), %lld rejected, %.2fus per validation."),
+				validations, elapsed, validations / elapsed, rejections,
+				validations > 0 ? FPlatformTime::ToSeconds64(cycles) * 1000000.0 / validations : 0.0);
+		}));
+}
+
+FVehicleValidationLimits::FVehicleValidationLimits()
+{
+	SampleRange = 0.f;
+	MaxSpeed = 0.f;
+	MaxReverseSpeed = 0.f;
+	Tolerance = 0.f;
+}
+
+void FVehicleValidationLimits::Bake(const FVehicleEngineSettings& Engine, float InTolerance)
+{
+	MaxSpeed = Engine.MaxSpeed;
+	MaxReverseSpeed = Engine.MaxReverseSpeed;
+	Tolerance = InTolerance;
+
+	/* Cover speeds beyond the max speed as well, so the max speed multiplier above 1 is sampled too. */
+	SampleRange = FMath::Max(FMath::Max(MaxSpeed, MaxReverseSpeed) * 2.f, 1.f);
+	ArcadeVehicleStateValidation::BakeCurve(Engine.AccelerationCurve, SampleRange, AccelerationSamples);
+	ArcadeVehicleStateValidation::BakeCurve(Engine.ReversingCurve, SampleRange, ReversingSamples);
+	ArcadeVehicleStateValidation::BakeCurve(Engine.BrakingCurve, SampleRange, BrakingSamples);
+}
+
+float FVehicleValidationLimits::SampleCurve(const TArray<float>& Samples, float Speed) const
+{
+	if(Samples.Num() == 0)
+	{
+		return 0.f;
+	}
+
+	const float position = FMath::Clamp(FMath::Abs(Speed) / SampleRange, 0.f, 1.f) * (Samples.Num() - 1);
+	const int32 index = FMath::Min(FMath::FloorToInt(position), Samples.Num() - 2);
+	return index < 0 ? Samples[0] : FMath::Lerp(Samples[index], Samples[index + 1], position - index);
+}
+
+FVehicleValidationJob::FVehicleValidationJob()
+{
+	bHasPreviousState = false;
+	MaxSpeedMultiplier = 1.f;
+	Gravity = 0.f;
+}
+
+VehicleStateVerdict FVehicleValidationJob::Validate() const
+{
+	const FVehicleValidationLimits& limits = *Limits;
+	const float toleranceScale = 1.f + limits.Tolerance;
+
+	/* Speed against the max speed of the vehicle. Reversing has its own limit. */
+	const FVector forward = State.Rotation.Vector();
+	const float forwardSpeed = FVector::DotProduct(State.LinearVelocity, forward) * KMH_MULTIPLIER;
+	const float maxSpeed = (forwardSpeed >= 0.f ? limits.MaxSpeed : limits.MaxReverseSpeed) * MaxSpeedMultiplier;
+	if(FMath::Abs(forwardSpeed) > maxSpeed * toleranceScale + ArcadeVehicleStateValidation::SpeedSlack)
+	{
+		return VehicleStateVerdict::ExceededSpeed;
+	}
+
+	/* The rest needs the previous state, close enough in time. */
+	const float deltaTime = static_cast<float>(State.TimeStamp.ToSeconds() - PreviousState.TimeStamp.ToSeconds());
+	if(!bHasPreviousState || deltaTime <= 0.f || deltaTime > ArcadeVehicleStateValidation::MaxValidatedDeltaTime)
+	{
+		return VehicleStateVerdict::Valid;
+	}
+
+	/* Speed gained against the strongest engine force, with gravity allowed to help downhill. */
+	const float previousSpeed = PreviousState.LinearVelocity.Size() * KMH_MULTIPLIER;
+	const float speed = State.LinearVelocity.Size() * KMH_MULTIPLIER;
+	const float maxEngineAcceleration = FMath::Max3(
+		limits.SampleCurve(limits.AccelerationSamples, previousSpeed),
+		limits.SampleCurve(limits.ReversingSamples, previousSpeed),
+		limits.SampleCurve(limits.BrakingSamples, previousSpeed));
+	const float maxAcceleration = (maxEngineAcceleration * UArcadeVehicleMovementComponentBase::ForcesTimeScale + FMath::Abs(Gravity)) * KMH_MULTIPLIER;
+	if(speed - previousSpeed > maxAcceleration * deltaTime * toleranceScale + ArcadeVehicleStateValidation::SpeedSlack)
+	{
+		return VehicleStateVerdict::ExceededAcceleration;
+	}
+
+	/* Distance travelled against the faster of both states. */
+	const float maxDistance = FMath::Max(previousSpeed, speed) / KMH_MULTIPLIER * deltaTime * toleranceScale + ArcadeVehicleStateValidation::ContinuitySlack;
+	if(FVector::DistSquared(PreviousState.Location, State.Location) > FMath::Square(maxDistance))
+	{
+		return VehicleStateVerdict::BrokeContinuity;
+	}
+
+	/* Forward speed against the re-simulation of the received inputs. */
+	if(forwardSpeed > ResimulateForwardSpeed(deltaTime) * toleranceScale + ArcadeVehicleStateValidation::SpeedSlack)
+	{
+		return VehicleStateVerdict::FailedResimulation;
+	}
+
+	return VehicleStateVerdict::Valid;
+}
+
+float FVehicleValidationJob::ResimulateForwardSpeed(float DeltaTime) const
+{
+	const FVehicleValidationLimits& limits = *Limits;
+	const float maxSpeed = limits.MaxSpeed * MaxSpeedMultiplier;
+	const float maxReverseSpeed = limits.MaxReverseSpeed * MaxSpeedMultiplier;
+	const float gravityGain = FMath::Abs(Gravity) * KMH_MULTIPLIER * ArcadeVehicleStateValidation::ResimulationStep;
+
+	/* Inputs are newest first, and are spread evenly over the time between the states. Without inputs, the input of the state is used. */
+	const int32 steps = FMath::Max(1, FMath::CeilToInt(DeltaTime / ArcadeVehicleStateValidation::ResimulationStep));
+	float speed = FVector::DotProduct(PreviousState.LinearVelocity, PreviousState.Rotation.Vector()) * KMH_MULTIPLIER;
+	for(int32 step = 0; step < steps; ++step)
+	{
+		const int32 inputIndex = Inputs.Num() > 0 ? Inputs.Num() - 1 - step * Inputs.Num() / steps : INDEX_NONE;
+		const FVehicleInputState& input = Inputs.IsValidIndex(inputIndex) ? Inputs[inputIndex] : State.Input;
+		const float accelerationInput = input.AccelerationInput.ToFloat();
+
+		/* Upper bound of the speed, so braking and engine braking are ignored and gravity always helps. */
+		float acceleration = 0.f;
+		if(accelerationInput > 0.f && speed < maxSpeed)
+		{
+			acceleration = limits.SampleCurve(limits.AccelerationSamples, speed) * accelerationInput;
+		}
+		speed += acceleration * UArcadeVehicleMovementComponentBase::ForcesTimeScale * KMH_MULTIPLIER * ArcadeVehicleStateValidation::ResimulationStep + gravityGain;
+		speed = FMath::Max(speed, -maxReverseSpeed);
+	}
+
+	return speed;
+}
@@ -0,0 +1,815 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#include "Networking/Iris/ArcadeVehicleNetSerializers.h"
+#include "Networking/ArcadeVehicleNetSerialization.h"
+#include "Networking/ArcadeVehicleNetworkHelpers.h"
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/BitPacking.h"
+#include "Iris/Serialization/NetSerializerDelegates.h"
+#include "Iris/ReplicationState/PropertyNetSerializerInfoRegistry.h"
+
+namespace UE::Net
+{
+	/**
+		Iris serializer of FFloat_NetQuantize and its variants. Quantizes the value the same way legacy NetSerialize does,
+		using the quantizer of the source type. Delta serialization sends a single bit for unchanged value.
+	*/
+	template<typename InSourceType>
+	struct TFloatNetQuantizeNetSerializer
+	{
+		static const uint32 Version = 0;
+
+		typedef InSourceType SourceType;
+		typedef uint32 QuantizedType;
+		typedef FFloatNetQuantizeNetSerializerConfig ConfigType;
+		typedef typename SourceType::FQuantizer QuantizerType;
+
+		static const ConfigType DefaultConfig;
+
+		/** Bits needed to send quantized value. */
+		static constexpr uint32 ValueBits = QuantizerType::NumBits;
+
+		static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+		{
+			const QuantizedType value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+			Context.GetBitStreamWriter()->WriteBits(value, ValueBits);
+		}
+
+		static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+		{
+			QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+			target = Context.GetBitStreamReader()->ReadBits(ValueBits);
+		}
+
+		static void SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args)
+		{
+			const QuantizedType value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+			const QuantizedType prevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+			FNetBitStreamWriter* pWriter = Context.GetBitStreamWriter();
+			if(pWriter->WriteBool(value != prevValue))
+			{
+				pWriter->WriteBits(value, ValueBits);
+			}
+		}
+
+		static void DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args)
+		{
+			QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+			const QuantizedType prevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+			FNetBitStreamReader* pReader = Context.GetBitStreamReader();
+			target = pReader->ReadBool() ? pReader->ReadBits(ValueBits) : prevValue;
+		}
+
+		static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+		{
+			const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+			QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+			target = QuantizerType::Quantize(source.ToFloat());
+		}
+
+		static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+		{
+			const QuantizedType& source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+			SourceType& target = *reinterpret_cast<SourceType*>(Args.Target);
+			target = QuantizerType::Dequantize(source);
+		}
+
+		static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+		{
+			if(Args.bStateIsQuantized)
+			{
+				return *reinterpret_cast<const QuantizedType*>(Args.Source0) == *reinterpret_cast<const QuantizedType*>(Args.Source1);
+			}
+
+			const SourceType& value0 = *reinterpret_cast<const SourceType*>(Args.Source0);
+			const SourceType& value1 = *reinterpret_cast<const SourceType*>(Args.Source1);
+			return value0 == value1.ToFloat();
+		}
+
+		static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+		{
+			const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+			return FMath::IsFinite(source.ToFloat());
+		}
+	};
+
+	template<typename InSourceType>
+	const typename TFloatNetQuantizeNetSerializer<InSourceType>::ConfigType TFloatNetQuantizeNetSerializer<InSourceType>::DefaultConfig;
+
+	typedef TFloatNetQuantizeNetSerializer<FFloat_NetQuantize> FFloatNetQuantizeNetSerializer;
+	typedef TFloatNetQuantizeNetSerializer<FFloat_NetQuantize12> FFloatNetQuantize12NetSerializer;
+
+	/** Registers serializers of all the float quantization variants. Templated serializers can't own static registration objects. */
+	class FFloatNetQuantizeNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+	{
+	public:
+		virtual ~FFloatNetQuantizeNetSerializerRegistryDelegates();
+
+	private:
+		virtual void OnPreFreezeNetSerializerRegistry() override;
+	};
+
+	/**
+		Iris serializer of FVector2D_NetQuantize. Components are rounded to integers and limited to 20 bits of magnitude, as in legacy NetSerialize.
+		Only as many bits as the larger component needs are sent. Delta serialization sends a single bit for unchanged value.
+	*/
+	struct FVector2DNetQuantizeNetSerializer
+	{
+		static const uint32 Version = 0;
+
+		struct FQuantizedType
+		{
+			int32 X;
+			int32 Y;
+		};
+
+		typedef FVector2D_NetQuantize SourceType;
+		typedef FQuantizedType QuantizedType;
+		typedef FVector2DNetQuantizeNetSerializerConfig ConfigType;
+
+		static const ConfigType DefaultConfig;
+
+		/** Max bits of the component magnitude and bits needed to send the bit count. */
+		static constexpr uint32 MaxMagnitudeBits = 20;
+		static constexpr uint32 BitCountBits = 5;
+
+		static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+		static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+		static void SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args);
+		static void DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args);
+		static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+		static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+		static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+		static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+	private:
+		class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+		{
+		public:
+			virtual ~FNetSerializerRegistryDelegates();
+
+		private:
+			virtual void OnPreFreezeNetSerializerRegistry() override;
+		};
+
+		static FVector2DNetQuantizeNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+	};
+
+	/**
+		Iris serializer of FTimeStamp_NetQuantize. Time is quantized to ticks the same way legacy NetSerialize does.
+		Delta serialization sends packed difference from the baseline of the connection, which is small for regularly updated time stamps.
+	*/
+	struct FTimeStampNetQuantizeNetSerializer
+	{
+		static const uint32 Version = 0;
+
+		typedef FTimeStamp_NetQuantize SourceType;
+		typedef int64 QuantizedType;
+		typedef FTimeStampNetQuantizeNetSerializerConfig ConfigType;
+
+		static const ConfigType DefaultConfig;
+
+		static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+		static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+		static void SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args);
+		static void DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args);
+		static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+		static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+		static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+		static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+	private:
+		class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+		{
+		public:
+			virtual ~FNetSerializerRegistryDelegates();
+
+		private:
+			virtual void OnPreFreezeNetSerializerRegistry() override;
+		};
+
+		static FTimeStampNetQuantizeNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+	};
+
+	/**
+		Iris serializer of FVector_NetQuantizeCell. Location is split into cell and offset the same way legacy NetSerialize does.
+		Delta serialization sends the cell only when it has changed, which is rare, so most updates cost just the offset bits.
+	*/
+	struct FVectorNetQuantizeCellNetSerializer
+	{
+		static const uint32 Version = 0;
+
+		struct FQuantizedType
+		{
+			int32 Cell[3];
+			int32 Offset[3];
+		};
+
+		typedef FVector_NetQuantizeCell SourceType;
+		typedef FQuantizedType QuantizedType;
+		typedef FVectorNetQuantizeCellNetSerializerConfig ConfigType;
+
+		static const ConfigType DefaultConfig;
+
+		static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+		static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+		static void SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args);
+		static void DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args);
+		static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+		static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+		static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+		static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+	private:
+		/** Writes and reads the offsets, each with number of bits given by the cell size. Offsets are biased, so they are written as unsigned values. */
+		static void WriteOffsets(FNetBitStreamWriter* pWriter, const QuantizedType& Value);
+		static void ReadOffsets(FNetBitStreamReader* pReader, QuantizedType& Value);
+
+		class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+		{
+		public:
+			virtual ~FNetSerializerRegistryDelegates();
+
+		private:
+			virtual void OnPreFreezeNetSerializerRegistry() override;
+		};
+
+		static FVectorNetQuantizeCellNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+	};
+
+	/**
+		Iris serializer of FVehicleInputHistory. Inputs are quantized with the quantizers of their fields, the same way legacy NetSerialize does,
+		into fixed array sized for the max number of inputs, so the serializer needs no dynamic state.
+		Every input after the newest one costs single bit when it repeats the newer input. History changes with every packet, so there is no delta.
+	*/
+	struct FVehicleInputHistoryNetSerializer
+	{
+		static const uint32 Version = 0;
+
+		struct FQuantizedInput
+		{
+			uint32 AccelerationInput;
+			uint32 TurningInput;
+			uint32 CustomInput;
+			uint8 CustomBitflags;
+			uint8 InternalBitflags;
+		};
+
+		struct FQuantizedType
+		{
+			FQuantizedInput Inputs[FVehicleInputHistory::MaxInputs];
+			uint16 Sequence;
+			uint8 Count;
+		};
+
+		typedef FVehicleInputHistory SourceType;
+		typedef FQuantizedType QuantizedType;
+		typedef FVehicleInputHistoryNetSerializerConfig ConfigType;
+
+		static const ConfigType DefaultConfig;
+
+		/** Bits needed to send number of inputs. */
+		static constexpr uint32 CountBits = 4;
+		static_assert((1U << CountBits) > static_cast<uint32>(FVehicleInputHistory::MaxInputs), "Count bits can't hold max number of inputs.");
+
+		static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+		static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+		static void SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args);
+		static void DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args);
+		static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+		static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+		static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+		static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+	private:
+		/** Checks if both quantized inputs are the same. */
+		static bool IsInputEqual(const FQuantizedInput& A, const FQuantizedInput& B);
+
+		class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+		{
+		public:
+			virtual ~FNetSerializerRegistryDelegates();
+
+		private:
+			virtual void OnPreFreezeNetSerializerRegistry() override;
+		};
+
+		static FVehicleInputHistoryNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+	};
+
+	UE_NET_IMPLEMENT_SERIALIZER(FFloatNetQuantizeNetSerializer);
+	UE_NET_IMPLEMENT_SERIALIZER(FFloatNetQuantize12NetSerializer);
+	UE_NET_IMPLEMENT_SERIALIZER(FVector2DNetQuantizeNetSerializer);
+	UE_NET_IMPLEMENT_SERIALIZER(FTimeStampNetQuantizeNetSerializer);
+	UE_NET_IMPLEMENT_SERIALIZER(FVectorNetQuantizeCellNetSerializer);
+	UE_NET_IMPLEMENT_SERIALIZER(FVehicleInputHistoryNetSerializer);
+
+	static FFloatNetQuantizeNetSerializerRegistryDelegates FloatNetQuantizeNetSerializerRegistryDelegates;
+
+	const FVector2DNetQuantizeNetSerializer::ConfigType FVector2DNetQuantizeNetSerializer::DefaultConfig;
+	FVector2DNetQuantizeNetSerializer::FNetSerializerRegistryDelegates FVector2DNetQuantizeNetSerializer::NetSerializerRegistryDelegates;
+
+	const FTimeStampNetQuantizeNetSerializer::ConfigType FTimeStampNetQuantizeNetSerializer::DefaultConfig;
+	FTimeStampNetQuantizeNetSerializer::FNetSerializerRegistryDelegates FTimeStampNetQuantizeNetSerializer::NetSerializerRegistryDelegates;
+
+	const FVectorNetQuantizeCellNetSerializer::ConfigType FVectorNetQuantizeCellNetSerializer::DefaultConfig;
+	FVectorNetQuantizeCellNetSerializer::FNetSerializerRegistryDelegates FVectorNetQuantizeCellNetSerializer::NetSerializerRegistryDelegates;
+
+	const FVehicleInputHistoryNetSerializer::ConfigType FVehicleInputHistoryNetSerializer::DefaultConfig;
+	FVehicleInputHistoryNetSerializer::FNetSerializerRegistryDelegates FVehicleInputHistoryNetSerializer::NetSerializerRegistryDelegates;
+
+	/* Registration of the serializers for the structs using them. Names are struct names without the prefix. */
+	static const FName PropertyNetSerializerRegistry_NAME_Float_NetQuantize("Float_NetQuantize");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Float_NetQuantize, FFloatNetQuantizeNetSerializer);
+
+	static const FName PropertyNetSerializerRegistry_NAME_Float_NetQuantize12("Float_NetQuantize12");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Float_NetQuantize12, FFloatNetQuantize12NetSerializer);
+
+	static const FName PropertyNetSerializerRegistry_NAME_Vector2D_NetQuantize("Vector2D_NetQuantize");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Vector2D_NetQuantize, FVector2DNetQuantizeNetSerializer);
+
+	static const FName PropertyNetSerializerRegistry_NAME_TimeStamp_NetQuantize("TimeStamp_NetQuantize");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_TimeStamp_NetQuantize, FTimeStampNetQuantizeNetSerializer);
+
+	static const FName PropertyNetSerializerRegistry_NAME_Vector_NetQuantizeCell("Vector_NetQuantizeCell");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Vector_NetQuantizeCell, FVectorNetQuantizeCellNetSerializer);
+
+	static const FName PropertyNetSerializerRegistry_NAME_VehicleInputHistory("VehicleInputHistory");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_VehicleInputHistory, FVehicleInputHistoryNetSerializer);
+
+	/* Float serializers registration. */
+	FFloatNetQuantizeNetSerializerRegistryDelegates::~FFloatNetQuantizeNetSerializerRegistryDelegates()
+	{
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Float_NetQuantize);
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Float_NetQuantize12);
+	}
+
+	void FFloatNetQuantizeNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+	{
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Float_NetQuantize);
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Float_NetQuantize12);
+	}
+
+	/* FVector2DNetQuantizeNetSerializer. */
+	void FVector2DNetQuantizeNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+	{
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		FNetBitStreamWriter* pWriter = Context.GetBitStreamWriter();
+
+		/* Send only as many bits as the larger component needs, plus the sign bit. */
+		const uint32 magnitude = static_cast<uint32>(FMath::Max(FMath::Abs(value.X), FMath::Abs(value.Y)));
+		const uint32 bitCount = FMath::Clamp<uint32>(FMath::CeilLogTwo(magnitude + 1U), 1U, MaxMagnitudeBits) + 1U;
+		const int32 bias = 1 << (bitCount - 1U);
+		pWriter->WriteBits(bitCount, BitCountBits);
+		pWriter->WriteBits(static_cast<uint32>(value.X + bias), bitCount);
+		pWriter->WriteBits(static_cast<uint32>(value.Y + bias), bitCount);
+	}
+
+	void FVector2DNetQuantizeNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+	{
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		FNetBitStreamReader* pReader = Context.GetBitStreamReader();
+
+		const uint32 bitCount = FMath::Clamp<uint32>(pReader->ReadBits(BitCountBits), 2U, MaxMagnitudeBits + 1U);
+		const int32 bias = 1 << (bitCount - 1U);
+		target.X = static_cast<int32>(pReader->ReadBits(bitCount)) - bias;
+		target.Y = static_cast<int32>(pReader->ReadBits(bitCount)) - bias;
+	}
+
+	void FVector2DNetQuantizeNetSerializer::SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args)
+	{
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		const QuantizedType& prevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+		if(Context.GetBitStreamWriter()->WriteBool(value.X != prevValue.X || value.Y != prevValue.Y))
+		{
+			Serialize(Context, Args);
+		}
+	}
+
+	void FVector2DNetQuantizeNetSerializer::DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args)
+	{
+		if(Context.GetBitStreamReader()->ReadBool())
+		{
+			Deserialize(Context, Args);
+		}
+		else
+		{
+			*reinterpret_cast<QuantizedType*>(Args.Target) = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+		}
+	}
+
+	void FVector2DNetQuantizeNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+	{
+		const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		const int32 maxValue = (1 << MaxMagnitudeBits) - 1;
+		target.X = FMath::Clamp(FMath::RoundToInt(source.X), -maxValue, maxValue);
+		target.Y = FMath::Clamp(FMath::RoundToInt(source.Y), -maxValue, maxValue);
+	}
+
+	void FVector2DNetQuantizeNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+	{
+		const QuantizedType& source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		SourceType& target = *reinterpret_cast<SourceType*>(Args.Target);
+		target.X = source.X;
+		target.Y = source.Y;
+	}
+
+	bool FVector2DNetQuantizeNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+	{
+		if(Args.bStateIsQuantized)
+		{
+			const QuantizedType& value0 = *reinterpret_cast<const QuantizedType*>(Args.Source0);
+			const QuantizedType& value1 = *reinterpret_cast<const QuantizedType*>(Args.Source1);
+			return value0.X == value1.X && value0.Y == value1.Y;
+		}
+
+		return *reinterpret_cast<const SourceType*>(Args.Source0) == *reinterpret_cast<const SourceType*>(Args.Source1);
+	}
+
+	bool FVector2DNetQuantizeNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+	{
+		const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+		return !source.ContainsNaN();
+	}
+
+	FVector2DNetQuantizeNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates()
+	{
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Vector2D_NetQuantize);
+	}
+
+	void FVector2DNetQuantizeNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+	{
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Vector2D_NetQuantize);
+	}
+
+	/* FTimeStampNetQuantizeNetSerializer. */
+	void FTimeStampNetQuantizeNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+	{
+		const QuantizedType value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		WritePackedUint64(Context.GetBitStreamWriter(), SourceType::ZigZagEncode(value));
+	}
+
+	void FTimeStampNetQuantizeNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+	{
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		target = SourceType::ZigZagDecode(ReadPackedUint64(Context.GetBitStreamReader()));
+	}
+
+	void FTimeStampNetQuantizeNetSerializer::SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args)
+	{
+		const QuantizedType value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		const QuantizedType prevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+		WritePackedUint64(Context.GetBitStreamWriter(), SourceType::ZigZagEncode(value - prevValue));
+	}
+
+	void FTimeStampNetQuantizeNetSerializer::DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args)
+	{
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		const QuantizedType prevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+		target = prevValue + SourceType::ZigZagDecode(ReadPackedUint64(Context.GetBitStreamReader()));
+	}
+
+	void FTimeStampNetQuantizeNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+	{
+		const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		target = SourceType::ToTicks(source.ToSeconds());
+	}
+
+	void FTimeStampNetQuantizeNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+	{
+		const QuantizedType& source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		SourceType& target = *reinterpret_cast<SourceType*>(Args.Target);
+		target = SourceType::FromTicks(source);
+	}
+
+	bool FTimeStampNetQuantizeNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+	{
+		if(Args.bStateIsQuantized)
+		{
+			return *reinterpret_cast<const QuantizedType*>(Args.Source0) == *reinterpret_cast<const QuantizedType*>(Args.Source1);
+		}
+
+		const SourceType& value0 = *reinterpret_cast<const SourceType*>(Args.Source0);
+		const SourceType& value1 = *reinterpret_cast<const SourceType*>(Args.Source1);
+		return value0.ToSeconds() == value1.ToSeconds();
+	}
+
+	bool FTimeStampNetQuantizeNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+	{
+		const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+		return FMath::IsFinite(source.ToSeconds());
+	}
+
+	FTimeStampNetQuantizeNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates()
+	{
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_TimeStamp_NetQuantize);
+	}
+
+	void FTimeStampNetQuantizeNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+	{
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_TimeStamp_NetQuantize);
+	}
+
+	/* FVectorNetQuantizeCellNetSerializer. */
+	void FVectorNetQuantizeCellNetSerializer::WriteOffsets(FNetBitStreamWriter* pWriter, const QuantizedType& Value)
+	{
+		const uint32 offsetBits = SourceType::GetOffsetBits();
+		const int32 offsetSteps = SourceType::GetOffsetSteps();
+		for(int32 i = 0; i < 3; ++i)
+		{
+			pWriter->WriteBits(static_cast<uint32>(Value.Offset[i] + offsetSteps), offsetBits);
+		}
+	}
+
+	void FVectorNetQuantizeCellNetSerializer::ReadOffsets(FNetBitStreamReader* pReader, QuantizedType& Value)
+	{
+		const uint32 offsetBits = SourceType::GetOffsetBits();
+		const int32 offsetSteps = SourceType::GetOffsetSteps();
+		for(int32 i = 0; i < 3; ++i)
+		{
+			Value.Offset[i] = FMath::Clamp(static_cast<int32>(pReader->ReadBits(offsetBits)) - offsetSteps, -offsetSteps, offsetSteps);
+		}
+	}
+
+	void FVectorNetQuantizeCellNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+	{
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		FNetBitStreamWriter* pWriter = Context.GetBitStreamWriter();
+
+		/* Origin cell, which covers small worlds completely, costs single bit. */
+		if(pWriter->WriteBool(value.Cell[0] != 0 || value.Cell[1] != 0 || value.Cell[2] != 0))
+		{
+			for(int32 i = 0; i < 3; ++i)
+			{
+				WritePackedInt32(pWriter, value.Cell[i]);
+			}
+		}
+		WriteOffsets(pWriter, value);
+	}
+
+	void FVectorNetQuantizeCellNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+	{
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		FNetBitStreamReader* pReader = Context.GetBitStreamReader();
+
+		const bool bHasCell = pReader->ReadBool();
+		for(int32 i = 0; i < 3; ++i)
+		{
+			target.Cell[i] = bHasCell ? ReadPackedInt32(pReader) : 0;
+		}
+		ReadOffsets(pReader, target);
+	}
+
+	void FVectorNetQuantizeCellNetSerializer::SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args)
+	{
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		const QuantizedType& prevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+		FNetBitStreamWriter* pWriter = Context.GetBitStreamWriter();
+
+		/* Cell is sent only when the vehicle has moved to another one. */
+		if(pWriter->WriteBool(value.Cell[0] != prevValue.Cell[0] || value.Cell[1] != prevValue.Cell[1] || value.Cell[2] != prevValue.Cell[2]))
+		{
+			for(int32 i = 0; i < 3; ++i)
+			{
+				WritePackedInt32(pWriter, value.Cell[i] - prevValue.Cell[i]);
+			}
+		}
+		WriteOffsets(pWriter, value);
+	}
+
+	void FVectorNetQuantizeCellNetSerializer::DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args)
+	{
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		const QuantizedType& prevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+		FNetBitStreamReader* pReader = Context.GetBitStreamReader();
+
+		const bool bCellChanged = pReader->ReadBool();
+		for(int32 i = 0; i < 3; ++i)
+		{
+			target.Cell[i] = prevValue.Cell[i] + (bCellChanged ? ReadPackedInt32(pReader) : 0);
+		}
+		ReadOffsets(pReader, target);
+	}
+
+	void FVectorNetQuantizeCellNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+	{
+		const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		for(int32 i = 0; i < 3; ++i)
+		{
+			SourceType::QuantizeComponent(source.Component(i), target.Cell[i], target.Offset[i]);
+		}
+	}
+
+	void FVectorNetQuantizeCellNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+	{
+		const QuantizedType& source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		SourceType& target = *reinterpret_cast<SourceType*>(Args.Target);
+		target.X = SourceType::DequantizeComponent(source.Cell[0], source.Offset[0]);
+		target.Y = SourceType::DequantizeComponent(source.Cell[1], source.Offset[1]);
+		target.Z = SourceType::DequantizeComponent(source.Cell[2], source.Offset[2]);
+	}
+
+	bool FVectorNetQuantizeCellNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+	{
+		if(Args.bStateIsQuantized)
+		{
+			const QuantizedType& value0 = *reinterpret_cast<const QuantizedType*>(Args.Source0);
+			const QuantizedType& value1 = *reinterpret_cast<const QuantizedType*>(Args.Source1);
+			return FMemory::Memcmp(&value0, &value1, sizeof(QuantizedType)) == 0;
+		}
+
+		return *reinterpret_cast<const SourceType*>(Args.Source0) == *reinterpret_cast<const SourceType*>(Args.Source1);
+	}
+
+	bool FVectorNetQuantizeCellNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+	{
+		const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+		return !source.ContainsNaN();
+	}
+
+	FVectorNetQuantizeCellNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates()
+	{
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Vector_NetQuantizeCell);
+	}
+
+	void FVectorNetQuantizeCellNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+	{
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_Vector_NetQuantizeCell);
+	}
+
+	/* FVehicleInputHistoryNetSerializer. */
+	bool FVehicleInputHistoryNetSerializer::IsInputEqual(const FQuantizedInput& A, const FQuantizedInput& B)
+	{
+		return A.AccelerationInput == B.AccelerationInput
+			&& A.TurningInput == B.TurningInput
+			&& A.CustomInput == B.CustomInput
+			&& A.CustomBitflags == B.CustomBitflags
+			&& A.InternalBitflags == B.InternalBitflags;
+	}
+
+	void FVehicleInputHistoryNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+	{
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		FNetBitStreamWriter* pWriter = Context.GetBitStreamWriter();
+
+		pWriter->WriteBits(value.Count, CountBits);
+		pWriter->WriteBits(value.Sequence, 16U);
+		for(uint32 i = 0; i < value.Count; ++i)
+		{
+			/* Every input after the newest one starts with a bit telling if it repeats the newer input. */
+			const FQuantizedInput& input = value.Inputs[i];
+			if(i > 0 && pWriter->WriteBool(IsInputEqual(input, value.Inputs[i - 1])))
+			{
+				continue;
+			}
+
+			pWriter->WriteBits(input.AccelerationInput, FFloat_NetQuantize::FQuantizer::NumBits);
+			pWriter->WriteBits(input.TurningInput, FFloat_NetQuantize12::FQuantizer::NumBits);
+			pWriter->WriteBits(input.CustomInput, FFloat_NetQuantize::FQuantizer::NumBits);
+			pWriter->WriteBits(input.CustomBitflags, 8U);
+			pWriter->WriteBits(input.InternalBitflags, 8U);
+		}
+	}
+
+	void FVehicleInputHistoryNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+	{
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		FNetBitStreamReader* pReader = Context.GetBitStreamReader();
+
+		target.Count = static_cast<uint8>(FMath::Min<uint32>(pReader->ReadBits(CountBits), FVehicleInputHistory::MaxInputs));
+		target.Sequence = static_cast<uint16>(pReader->ReadBits(16U));
+		for(uint32 i = 0; i < target.Count; ++i)
+		{
+			FQuantizedInput& input = target.Inputs[i];
+			if(i > 0 && pReader->ReadBool())
+			{
+				input = target.Inputs[i - 1];
+				continue;
+			}
+
+			input.AccelerationInput = pReader->ReadBits(FFloat_NetQuantize::FQuantizer::NumBits);
+			input.TurningInput = pReader->ReadBits(FFloat_NetQuantize12::FQuantizer::NumBits);
+			input.CustomInput = pReader->ReadBits(FFloat_NetQuantize::FQuantizer::NumBits);
+			input.CustomBitflags = static_cast<uint8>(pReader->ReadBits(8U));
+			input.InternalBitflags = static_cast<uint8>(pReader->ReadBits(8U));
+		}
+	}
+
+	void FVehicleInputHistoryNetSerializer::SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args)
+	{
+		Serialize(Context, Args);
+	}
+
+	void FVehicleInputHistoryNetSerializer::DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args)
+	{
+		Deserialize(Context, Args);
+	}
+
+	void FVehicleInputHistoryNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+	{
+		const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+		/* Unused inputs are cleared, so the quantized states compare equal. */
+		FMemory::Memzero(target);
+		target.Count = static_cast<uint8>(FMath::Min(source.Inputs.Num(), FVehicleInputHistory::MaxInputs));
+		target.Sequence = source.Sequence;
+		for(int32 i = 0; i < target.Count; ++i)
+		{
+			const FVehicleInputState& input = source.Inputs[i];
+			FQuantizedInput& quantizedInput = target.Inputs[i];
+			quantizedInput.AccelerationInput = FFloat_NetQuantize::FQuantizer::Quantize(input.AccelerationInput.ToFloat());
+			quantizedInput.TurningInput = FFloat_NetQuantize12::FQuantizer::Quantize(input.TurningInput.ToFloat());
+			quantizedInput.CustomInput = FFloat_NetQuantize::FQuantizer::Quantize(input.CustomInput.ToFloat());
+			quantizedInput.CustomBitflags = input.CustomBitflags;
+			quantizedInput.InternalBitflags = input.InternalBitflags;
+		}
+	}
+
+	void FVehicleInputHistoryNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+	{
+		const QuantizedType& source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		SourceType& target = *reinterpret_cast<SourceType*>(Args.Target);
+
+		target.Sequence = source.Sequence;
+		target.Inputs.SetNum(source.Count);
+		for(int32 i = 0; i < source.Count; ++i)
+		{
+			const FQuantizedInput& quantizedInput = source.Inputs[i];
+			FVehicleInputState& input = target.Inputs[i];
+			input.AccelerationInput = FFloat_NetQuantize::FQuantizer::Dequantize(quantizedInput.AccelerationInput);
+			input.TurningInput = FFloat_NetQuantize12::FQuantizer::Dequantize(quantizedInput.TurningInput);
+			input.CustomInput = FFloat_NetQuantize::FQuantizer::Dequantize(quantizedInput.CustomInput);
+			input.CustomBitflags = quantizedInput.CustomBitflags;
+			input.InternalBitflags = quantizedInput.InternalBitflags;
+		}
+	}
+
+	bool FVehicleInputHistoryNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+	{
+		if(Args.bStateIsQuantized)
+		{
+			const QuantizedType& value0 = *reinterpret_cast<const QuantizedType*>(Args.Source0);
+			const QuantizedType& value1 = *reinterpret_cast<const QuantizedType*>(Args.Source1);
+			if(value0.Count != value1.Count || value0.Sequence != value1.Sequence)
+			{
+				return false;
+			}
+			for(uint32 i = 0; i < value0.Count; ++i)
+			{
+				if(!IsInputEqual(value0.Inputs[i], value1.Inputs[i]))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		const SourceType& value0 = *reinterpret_cast<const SourceType*>(Args.Source0);
+		const SourceType& value1 = *reinterpret_cast<const SourceType*>(Args.Source1);
+		if(value0.Inputs.Num() != value1.Inputs.Num() || value0.Sequence != value1.Sequence)
+		{
+			return false;
+		}
+		for(int32 i = 0; i < value0.Inputs.Num(); ++i)
+		{
+			if(!value0.Inputs[i].Equals(value1.Inputs[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool FVehicleInputHistoryNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+	{
+		const SourceType& source = *reinterpret_cast<const SourceType*>(Args.Source);
+		if(source.Inputs.Num() > FVehicleInputHistory::MaxInputs)
+		{
+			return false;
+		}
+
+		for(const FVehicleInputState& input : source.Inputs)
+		{
+			if(!FMath::IsFinite(input.AccelerationInput.ToFloat()) || !FMath::IsFinite(input.TurningInput.ToFloat()) || !FMath::IsFinite(input.CustomInput.ToFloat()))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	FVehicleInputHistoryNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates()
+	{
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_VehicleInputHistory);
+	}
+
+	void FVehicleInputHistoryNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+	{
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_VehicleInputHistory);
+	}
+}
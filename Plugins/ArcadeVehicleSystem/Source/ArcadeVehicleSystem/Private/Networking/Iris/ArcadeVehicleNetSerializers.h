@@ -0,0 +1,51 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Iris/Serialization/NetSerializer.h"
+#include "ArcadeVehicleNetSerializers.generated.h"
+
+/** Config of the Iris serializers of FFloat_NetQuantize and its variants. */
+USTRUCT()
+struct FFloatNetQuantizeNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+/** Config of the Iris serializer of FVector2D_NetQuantize. */
+USTRUCT()
+struct FVector2DNetQuantizeNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+/** Config of the Iris serializer of FTimeStamp_NetQuantize. */
+USTRUCT()
+struct FTimeStampNetQuantizeNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+/** Config of the Iris serializer of FVector_NetQuantizeCell. */
+USTRUCT()
+struct FVectorNetQuantizeCellNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+/** Config of the Iris serializer of FVehicleInputHistory. */
+USTRUCT()
+struct FVehicleInputHistoryNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+namespace UE::Net
+{
+	UE_NET_DECLARE_SERIALIZER(FFloatNetQuantizeNetSerializer, ARCADEVEHICLESYSTEM_API);
+	UE_NET_DECLARE_SERIALIZER(FFloatNetQuantize12NetSerializer, ARCADEVEHICLESYSTEM_API);
+	UE_NET_DECLARE_SERIALIZER(FVector2DNetQuantizeNetSerializer, ARCADEVEHICLESYSTEM_API);
+	UE_NET_DECLARE_SERIALIZER(FTimeStampNetQuantizeNetSerializer, ARCADEVEHICLESYSTEM_API);
+	UE_NET_DECLARE_SERIALIZER(FVectorNetQuantizeCellNetSerializer, ARCADEVEHICLESYSTEM_API);
+	UE_NET_DECLARE_SERIALIZER(FVehicleInputHistoryNetSerializer, ARCADEVEHICLESYSTEM_API);
+}
@@ -93,6 +93,29 @@ FVehicleAdvancedSettings::FVehicleAdvancedSettings()
 	bEnableFriction = true;
 }
 
+FVehicleNetworkSettings::FVehicleNetworkSettings()
+{
+	ReplicationMode = VehicleReplicationMode::FullState;
+	KeyframeInterval = 100.f;
+	bBatchStateReplication = false;
+	SmoothingMode = VehicleSmoothingMode::ErrorCorrection;
+	MinInterpolationDelay = 50.f;
+	MaxInterpolationDelay = 300.f;
+	JitterDeviationMultiplier = 3.f;
+	MaxExtrapolationTime = 150.f;
+	bUseSynchronizedTime = false;
+	InputHistorySize = 4;
+	InputStepRate = 60.f;
+	bQuantizeInputsLocally = true;
+	bEnableNetDormancy = false;
+	NetDormancyDelay = 2000.f;
+	KinematicProxyDistance = 0.f;
+	bValidateClientStates = false;
+	StateValidationTolerance = 0.25f;
+	bServerAuthoritative = false;
+	RollbackTolerance = 20.f;
+}
+
 FVehicleSettings::FVehicleSettings()
 {
 }
@@ -10,6 +10,8 @@
 	Base for the animation instances that are driven by the arcade vehicle of this system.
 	Obviously, feel free to implement your own animation instance, but as a good base on how to use it,
 	this one is pretty good introduction and in most cases, there is all you need.
+	Movement state is captured into a snapshot on the game thread, and the animation is calculated from it
+	in the thread-safe update, so it can run on worker threads with the parallel animation evaluation.
 */
 UCLASS(BlueprintType, Blueprintable)
 class ARCADEVEHICLESYSTEM_API UArcadeVehicleAnimationInstance : public UAnimInstance
@@ -21,6 +23,7 @@ public:
 
 	/** UAnimInstance interface. */
 	void NativeUpdateAnimation(float DeltaSeconds) override;
+	void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
 	/** ~UAnimInstance interface. */
 
 	/**
@@ -67,4 +70,7 @@ protected:
 	/** Arcade vehicle movement component that calculates the movement that will then be animated via this anim instance. */
 	UPROPERTY()
 	UArcadeVehicleMovementComponent* m_pVehicleMovementComponent;
+
+	/** Movement state of the vehicle captured this frame. Calculations read it instead of the movement component, so they are thread-safe. */
+	FVehicleAnimationSnapshot Snapshot;
 };
\ No newline at end of file
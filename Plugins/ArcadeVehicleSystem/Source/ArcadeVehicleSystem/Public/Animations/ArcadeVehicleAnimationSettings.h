@@ -3,6 +3,8 @@
 #pragma once
 #include "ArcadeVehicleAnimationSettings.generated.h"
 
+class UArcadeVehicleMovementComponentBase;
+
 /**
 	Enumerator that allows to specify which side of the vehicle
 	the wheel belongs to.
@@ -235,4 +237,46 @@ struct ARCADEVEHICLESYSTEM_API FVehicleAnimationSettings
 	/** All roll settings for this vehicle animation. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Roll)
 	FVehicleAnimationRollSettings Roll;
-};
\ No newline at end of file
+};
+
+/** Spring data the animation of single wheel is calculated from. */
+struct FVehicleWheelSnapshot
+{
+	/** Target height of the spring, defining the wheel perimeter. */
+	float TargetHeight;
+
+	/** Current wheel offset and swing of the spring. */
+	float WheelOffset;
+	float CurrentSwing;
+};
+
+/**
+	Copy of the vehicle movement state the animation is calculated from.
+	It is captured on the game thread, so the animation itself can be calculated on worker threads without touching the movement component.
+*/
+struct ARCADEVEHICLESYSTEM_API FVehicleAnimationSnapshot
+{
+	FVehicleAnimationSnapshot();
+
+	/** Copies current state of given vehicle. */
+	void Capture(const UArcadeVehicleMovementComponentBase& Vehicle);
+
+	/** Whether or not the snapshot has been captured from a vehicle yet. */
+	bool bIsValid;
+
+	/** Movement values of the vehicle. */
+	float TurningInput;
+	float CurrentSpeed;
+	float LastAppliedAcceleration;
+	float LastAppliedBraking;
+	FVector LocalLinearVelocity;
+
+	/** Movement flags of the vehicle. */
+	bool bIsMovingBackward;
+	bool bIsAccelerating;
+	bool bIsBraking;
+	bool bIsEngineBraking;
+
+	/** Spring data of every wheel, in the order of the suspension springs. */
+	TArray<FVehicleWheelSnapshot, TInlineAllocator<8>> Wheels;
+};
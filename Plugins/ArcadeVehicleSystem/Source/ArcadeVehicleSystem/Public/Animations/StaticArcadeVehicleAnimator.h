@@ -10,10 +10,18 @@
 
 class UStaticArcadeVehicleMovementComponent;
 
+/** Relative transform of single wheel mesh, calculated along with the animation and applied later in the batched pass. */
+struct FStaticVehicleWheelTransform
+{
+	FVector Location;
+	FRotator Rotation;
+};
+
 /**
  * Component that is used to animate arcade vehicles, that use static mesh instead of skeletal.
  * It has exactly the same logic as skeletal version, but because static meshes can't have animations
  * this component handles the transform logic just like anim instance.
+ * It doesn't tick on its own. UStaticArcadeVehicleAnimatorSubsystem updates all animators of the world at once.
  */
 UCLASS(BlueprintType, Blueprintable, meta=(BlueprintSpawnableComponent))
 class ARCADEVEHICLESYSTEM_API UStaticArcadeVehicleAnimator : public UActorComponent
@@ -25,7 +33,7 @@ public:
 
 	/** UActorComponent interface. */
 	void BeginPlay() override;
-	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	/** ~UActorComponent interface. */
 
 	/**
@@ -41,23 +49,44 @@ public:
 	UFUNCTION(BlueprintNativeEvent, Category = Animation)
 	void ApplyAnimation();
 	void ApplyAnimation_Implementation();
+
+	/** Captures snapshot of the vehicle movement. Must be called on the game thread. */
+	void CaptureSnapshot();
+
+	/**
+	  * Calculates the whole animation from the captured snapshot. Doesn't touch any other object, so it is safe to call from any thread,
+	  * as long as the overridden Calculate functions keep to the same contract. Runs on the game thread if bCalculateOnGameThread is set.
+	*/
+	void CalculateAnimation(float DeltaTime);
 	
 protected:
-	/** Calculates wheels direction. */
+	/*
+	 * Calculate functions run on the worker threads, in parallel with other animators.
+	 * Overrides may only read Snapshot and write this animator's own Settings and calculated members.
+	 * Any access to other objects, including the owner, its components and the movement component, needs bCalculateOnGameThread.
+	 */
+
+	/** Calculates wheels direction. Worker thread, reads Snapshot, writes Settings.Wheels only. */
 	virtual void CalculateWheelsDirection(float DeltaTime);
 
-	/** Calculates wheels rotation. */
+	/** Calculates wheels rotation. Worker thread, reads Snapshot, writes Settings.Wheels only. */
 	virtual void CalculateWheelsRotation(float DeltaTime);
 
-	/** Calculates all wheels offsets from the suspension data. */
+	/** Calculates all wheels offsets from the suspension data. Worker thread, reads Snapshot.Wheels, writes Settings.Wheels only. */
 	virtual void CalculateWheelsOffsets(float DeltaTime);
 
-	/** Calculates tilt animation. */
+	/** Calculates tilt animation. Worker thread, reads Snapshot, writes Settings.Tilt and the cached flags only. */
 	virtual void CalculateTilt(float DeltaTime);
 
-	/** Calculates roll animation. */
+	/** Calculates roll animation. Worker thread, reads Snapshot, writes Settings.Roll only. */
 	virtual void CalculateRoll(float DeltaTime);
 
+	/**
+	  * Calculates final relative transforms of the body and wheel meshes, which are then applied by ApplyAnimation.
+	  * Worker thread, writes m_BodyRotation and m_WheelTransforms only. Meshes themselves are touched by ApplyAnimation on the game thread.
+	*/
+	virtual void CalculateTransforms(float DeltaTime);
+
 	/* Allocates wheel info array if empty. Returns true if allocated successfully. */
 	bool AllocateWheels(const FVehicleSuspensionSettings& Suspension);
 	
@@ -65,6 +94,10 @@ protected:
 	/** Total settings for this animation instance of the vehicle. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
 	FVehicleAnimationSettings Settings;
+
+	/** Calculates this animator on the game thread, after the parallel batch. Set by derived animators whose calculations touch other objects. */
+	UPROPERTY(EditAnywhere, Category = Settings)
+	bool bCalculateOnGameThread;
 	
 	/** Cached vehicle acceleration flag to see when it changes. */
 	UPROPERTY()
@@ -77,4 +110,16 @@ protected:
 	/** Arcade vehicle movement component that calculates the movement that will then be animated via this anim instance. */
 	UPROPERTY()
 	UStaticArcadeVehicleMovementComponent* m_pVehicleMovementComponent;
+
+	/** Movement state of the vehicle captured this frame. Calculations read it instead of the movement component, so they are thread-safe. */
+	FVehicleAnimationSnapshot Snapshot;
+
+	/** Calculated relative rotation of the body mesh. */
+	FRotator m_BodyRotation;
+
+	/** Calculated relative transforms of the wheel meshes, in the order of the wheel registry. */
+	TArray<FStaticVehicleWheelTransform, TInlineAllocator<8>> m_WheelTransforms;
+
+	/** Subsystem drives the animator, and its benchmark fills the snapshot directly. */
+	friend class UStaticArcadeVehicleAnimatorSubsystem;
 };
@@ -0,0 +1,47 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "StaticArcadeVehicleAnimatorSubsystem.generated.h"
+
+class UStaticArcadeVehicleAnimator;
+
+/**
+	Updates all static vehicle animators of the world in single tick, instead of each animator ticking on its own.
+	Snapshots of the vehicles are captured on the game thread, the animation math of all animators is then spread
+	over the worker threads, and the calculated transforms are applied to the meshes in single pass on the game thread.
+	Snapshots and calculated transforms stay in the animators, as the overridable calculations of derived animators work on them.
+	Only the list of the animators is contiguous, so each animator costs a pointer chase, but no tick function of its own.
+	Console commands:
+	- avs.Animation.Benchmark [Vehicles] [Frames]
+*/
+UCLASS()
+class ARCADEVEHICLESYSTEM_API UStaticArcadeVehicleAnimatorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** UTickableWorldSubsystem interface. */
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override;
+	/** ~UTickableWorldSubsystem interface. */
+
+	/** Starts animating given animator. Called by the animators once their wheels are allocated. */
+	void RegisterAnimator(UStaticArcadeVehicleAnimator* Animator);
+
+	/** Stops animating given animator. */
+	void UnregisterAnimator(UStaticArcadeVehicleAnimator* Animator);
+
+	/** Calculates given number of synthetic vehicles for given number of frames, serially and in parallel, and logs the timings. */
+	void RunBenchmark(int32 Vehicles, int32 Frames) const;
+
+private:
+	/** Calculates animation of all given animators, in parallel if requested. Animators with bCalculateOnGameThread are always calculated serially. */
+	static void CalculateAnimators(const TArray<UStaticArcadeVehicleAnimator*>& InAnimators, float DeltaTime, bool bParallel);
+
+	/** Registered animators, updated in this order every frame. Their data lives in the animators themselves. */
+	UPROPERTY()
+	TArray<UStaticArcadeVehicleAnimator*> Animators;
+};
@@ -4,14 +4,17 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PawnMovementComponent.h"
 #include "Networking/ArcadeVehicleNetworkHelpers.h"
+#include "Networking/ArcadeVehicleStateValidation.h"
 #include "Settings/ArcadeVehicleSettings.h"
 #include "ArcadeVehicleMovementComponentBase.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogArcadeVehicleMovement, Log, All);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FCalculateCustomVehicleMovement, UPrimitiveComponent*, InVehiclePhysicsMesh, const FVehicleInputState&, Input, float, DeltaSeconds);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnVehicleStateValidated, VehicleStateVerdict, Verdict, double, TimeStamp);
 
 class UArcadeVehiclePathFollowingComponent;
+class AArcadeVehicleStateManager;
 
 /** Accessible constant for converting UE velocity units to km/h. */
 static const float KMH_MULTIPLIER = 0.036f;
@@ -29,8 +32,15 @@ class ARCADEVEHICLESYSTEM_API UArcadeVehicleMovementComponentBase : public UPawn
 public:
 	UArcadeVehicleMovementComponentBase();
 
+	/**
+	 * Scale of the delta time the arcade forces are calculated with, matching simulation speeds of the previous movement curves.
+	 * Live step, rollback re-simulation and state validation all use it, so they can't drift apart.
+	 */
+	static constexpr float ForcesTimeScale = 8.f;
+
 	/** UActorComponent interface. */
 	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	void RegisterComponentTickFunctions(bool bRegister) override;
 	void SetComponentTickEnabled(bool bEnabled) override;
 	void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
@@ -226,6 +236,17 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Physics)
 	void TeleportVehicle(const FTransform& Transform);
 
+	/**
+		Teleports all of the vehicles to the transforms at the same index in one go, e.g. to place them on the starting grid.
+		Instead of the teleport rpcs of each vehicle, single placement message is sent to everyone, and every side applies it at the same server time,
+		given delay from now. Delay should cover the latency of the clients. Server only.
+	*/
+	UFUNCTION(BlueprintCallable, Category = Physics)
+	static void TeleportVehicles(const TArray<UArcadeVehicleMovementComponentBase*>& Vehicles, const TArray<FTransform>& Transforms, float Delay = 0.2f);
+
+	/** Teleports this vehicle locally, clearing its network data and physics state. Used by the teleport rpcs and the grid placement. */
+	void ApplyTeleport(const FVector& Location, const FRotator& Rotation);
+
 	/** Sets current linear velocity to the physics of the vehicle. Should only be called on the host-side. Velocity can be set in local or world space. */
 	UFUNCTION(BlueprintCallable, Category = Physics)
 	void SetVehicleLinearVelocity(const FVector& LinearVelocity, const bool WorldSpace = false);
@@ -238,7 +259,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Acceleration)
 	bool IsAccelerationBlocked() const;
 	
-	/** Function that allows to blocking acceleration. */
+	/** Function that allows to blocking acceleration. With server authority it is only allowed on the server. */
 	UFUNCTION(BlueprintCallable, Category = Acceleration)
 	void SetBlockAcceleration(bool Block);
 
@@ -262,6 +283,33 @@ public:
 
 	/** Checks if we have control over this vehicle. */
 	bool HasControlOverVehicle() const;
+
+	/** Checks if this vehicle runs in an offline session, without any networking. */
+	bool IsStandalone() const;
+
+	/** Returns latest physics state replicated by the server. */
+	const FVehiclePhysicsState& GetReplicatedState() const;
+
+	/** Called by the state manager when batched server state of this vehicle arrives. Acts as if the state was replicated by this component. */
+	void ReceiveBatchedState(const FVehiclePhysicsState& State);
+
+	/** Returns network telemetry gathered by this vehicle. */
+	const FVehicleNetTelemetry& GetNetTelemetry() const;
+
+	/** Clears network telemetry gathered by this vehicle. */
+	void ResetNetTelemetry();
+
+	/** Wakes this vehicle from net dormancy and restarts counting the time its state stays stable. Only has effect on the server. */
+	UFUNCTION(BlueprintCallable, Category = Networking)
+	void WakeFromNetDormancy();
+
+	/** Checks if the owner of this vehicle is currently net dormant. */
+	UFUNCTION(BlueprintPure, Category = Networking)
+	bool IsNetDormant() const;
+
+	/** Checks if this vehicle is currently a kinematic proxy, driven from received states without simulating physics. Interpolated vehicles always are. */
+	UFUNCTION(BlueprintPure, Category = Networking)
+	bool IsKinematicProxy() const;
 	
 protected:
 	/** Ticks before physics. */
@@ -298,6 +346,9 @@ protected:
 	/** Calculates physics runtime information for the simulation to have it in one place. */
 	virtual void CalculatePhysicsRuntimeData();
 
+	/** Updates physics runtime information from given rotation and world velocities. */
+	void UpdatePhysicsRuntime(const FQuat& Rotation, const FVector& LinearVelocity, const FVector& AngularVelocity);
+
 	/**
 	 * Returns wheels transform. It is transform that allows to offset wheels
 	 * for specific parent bone if needed.
@@ -325,11 +376,22 @@ protected:
 	
 	/** Calculates and outputs turning related maths as angular velocity. */
 	virtual void CalculateTurning(float DeltaTime, FVector& InOutAngularVelocity);
+
+	/**
+	 * Runs the arcade velocity calculations of single frame, from adherence to stabilization, on given local velocities.
+	 * Doesn't touch the physics body, so it is shared by the simulation and the re-simulation of the predicted frames.
+	 */
+	void CalculateVelocities(const FRotator& Rotation, float DeltaTime, FVector& InOutLinearVelocity, FVector& InOutAngularVelocity);
 	
 	/** Rpc called on the server when the client owning the vehicle sends its state. */
 	UFUNCTION(Server, Unreliable)
-	void OnReceiveState_Server(const FVehiclePhysicsState& State);
-	virtual void OnReceiveState_Server_Implementation(const FVehiclePhysicsState& State);
+	void OnReceiveState_Server(const FVehiclePhysicsState& State, const FVehicleInputHistory& History);
+	virtual void OnReceiveState_Server_Implementation(const FVehiclePhysicsState& State, const FVehicleInputHistory& History);
+
+	/** Rpc called on the server when the client owning the vehicle sends its input frame. Used by the input stream replication mode. */
+	UFUNCTION(Server, Unreliable)
+	void OnReceiveInput_Server(const FVehicleInputFrame& Frame, const FVehicleInputHistory& History);
+	virtual void OnReceiveInput_Server_Implementation(const FVehicleInputFrame& Frame, const FVehicleInputHistory& History);
 
 	/** Rpc called on the server when the client owning the vehicle sends teleport command. */
 	UFUNCTION(Server, Reliable)
@@ -344,22 +406,116 @@ protected:
 	/** Register members for syncing. */
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	/** Disables replication of the server state when it is batched by the state manager. */
+	void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
 	/** Returns state structure based on current physical properties. */
 	FVehiclePhysicsState BuildState() const;
 
+	/** Returns input frame structure based on current input. */
+	FVehicleInputFrame BuildInputFrame() const;
+
+	/** Checks if the controlling side should send full physics state keyframe this frame. */
+	bool ShouldSendKeyframe() const;
+
+	/** Checks if server states are batched by the state manager. They never are when the net driver uses a replication driver. */
+	bool IsBatchingStates() const;
+
+	/** Checks if the server-authoritative mode is active. */
+	bool IsServerAuthoritative() const;
+
+	/**
+	 * Replicates state simulated by the server in the server-authoritative mode to everyone else, and to the owning client
+	 * when the server has consumed its new input this frame.
+	 */
+	void PublishAuthoritativeState(const FVehiclePhysicsState& State);
+
+	/** Records frame predicted by the owning client for every input step completed this frame. */
+	void RecordPredictionFrames(const FVehiclePhysicsState& State, int32 InputSteps);
+
+	/**
+	 * Re-simulates single predicted frame on top of the previous one, on kinematic state. Arcade forces are calculated again,
+	 * while gravity, suspension and contacts can't be stepped without the physics engine, so their effects are taken from the prediction.
+	 */
+	void SimulateKinematicStep(const FVehiclePredictionFrame& Previous, FVehiclePredictionFrame& Frame);
+
+	/** Checks if this vehicle is allowed to go net dormant on this machine. */
+	bool CanBecomeNetDormant() const;
+
+	/**
+	 * Tracks how long the state of this vehicle stays stable, and wakes it up when it changes.
+	 * Returns true when the vehicle should flush its final keyframe and go dormant this frame.
+	 */
+	bool UpdateNetDormancy(const FVehiclePhysicsState& State);
+
+	/** Checks if this vehicle validates states sent by the controlling client on this machine. */
+	bool ShouldValidateStates() const;
+
+	/** Launches plausibility validation of the state received from the controlling client, against the previously received one. */
+	void ValidateState(const FVehiclePhysicsState& State, const FVehicleInputHistory& History);
+
+	/** Broadcasts verdicts of the finished state validations. */
+	void ProcessValidationResults();
+
+	/** Called when vehicle physics mesh hits something. Wakes the vehicle from net dormancy. */
+	UFUNCTION()
+	void OnVehicleHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
 	/** Called when server state arrives to client. */
 	UFUNCTION()
 	void OnRep_ServerState();
 
+	/** Called when server input frame arrives to client. */
+	UFUNCTION()
+	void OnRep_ServerInput();
+
+	/** Called when input history of the controlling side arrives to client. */
+	UFUNCTION()
+	void OnRep_ServerInputHistory();
+
+	/** Called when state simulated by the server arrives to the owning client. Rolls back the prediction if it differs. */
+	UFUNCTION()
+	void OnRep_AuthoritativeState();
+
+	/** Merges input history received from the controlling side into the remote input timeline. */
+	void ReceiveInputHistory(const FVehicleInputHistory& History);
+
+	/** Checks if the controlling side records its inputs into the input history. */
+	bool UsesInputHistory() const;
+
+	/** Returns length of single input step in seconds. */
+	float GetInputStepTime() const;
+
+	/** Advances the input step clock by given time. Returns how many input steps have been completed. */
+	int32 AdvanceInputSteps(float DeltaTime);
+
 	/** Returns half round-trip-time of the client owning this vehicle. */
 	float GetHalfRTT() const;
 
+	/** Returns time stamp the controlling side should send with its state or input, created at given local time. */
+	double GetOutgoingTimeStamp(double LocalTime) const;
+
+	/** Returns local time of the state or input with given time stamp, received from the server. */
+	double GetIncomingLocalTime(double TimeStamp) const;
+
 	/** Applies given physics corrections. */
 	virtual void ApplyPhysicsCorrections();
 
+	/** Checks if this vehicle is rendered from the interpolation jitter buffer on this machine. */
+	bool UsesInterpolation() const;
+
+	/** Samples interpolation jitter buffer and applies the sampled state to the vehicle. */
+	virtual void ApplyInterpolation();
+
+	/** Switches between kinematic proxy and full simulation depending on the distance from the local view. */
+	virtual void UpdateKinematicProxy();
+
 	/** Calculates angular distance between two rotations in degrees. */
 	static float AngularDistance(const FQuat& A, const FQuat& B);
 
+	/** Moves given state by its velocities for given time. Negative time moves it back. */
+	static FVehiclePhysicsState ExtrapolateState(const FVehiclePhysicsState& State, float Time);
+
 public:
 	/**
 	* Allows to implement additional custom movement logic. Called after all regular calculations.
@@ -367,6 +523,13 @@ public:
 	*/
 	UPROPERTY(BlueprintAssignable, Category=CustomMovement)
 	FCalculateCustomVehicleMovement CalculateCustomVehicleMovement;
+
+	/**
+	* Called on the server with verdict of the plausibility validation of the state sent by the controlling client.
+	* Only called when bValidateClientStates is enabled. Verdicts arrive a frame or more after the state itself.
+	*/
+	UPROPERTY(BlueprintAssignable, Category=Networking)
+	FOnVehicleStateValidated OnStateValidated;
 	
 protected:
 	/** Input state assigned for local player during pressing buttons etc. */
@@ -397,6 +560,15 @@ protected:
 	 */
 	bool bIsVehicleInitialized;
 
+	/** Whether or not this vehicle is currently a kinematic proxy. */
+	bool bIsKinematicProxy;
+
+	/** Whether or not this vehicle runs in an offline session. All of the networking work is skipped then. */
+	bool bIsStandalone;
+
+	/** Whether or not we have control over this vehicle. Cached on begin play and whenever the controller changes. */
+	bool bHasControlOverVehicle;
+
 	/**
 	 * Stores runtime wheels information.
 	 * Simply to avoid putting here another few variables.
@@ -421,7 +593,45 @@ private:
 	UPROPERTY(ReplicatedUsing=OnRep_ServerState)
 	FVehiclePhysicsState ServerState;
 
+	/** Latest input frame replicated from server to all clients. Only used by input stream replication mode. */
+	UPROPERTY(ReplicatedUsing=OnRep_ServerInput)
+	FVehicleInputFrame ServerInput;
+
+	/** Latest input history of the controlling side replicated from server to all clients. */
+	UPROPERTY(ReplicatedUsing=OnRep_ServerInputHistory)
+	FVehicleInputHistory ServerInputHistory;
+
+	/** State simulated by the server in the server-authoritative mode, replicated only to the owning client. */
+	UPROPERTY(ReplicatedUsing=OnRep_AuthoritativeState)
+	FVehicleAuthoritativeState AuthoritativeState;
+
+	/** Sequence of the last input of the owning client simulated by the server, and whether it has been consumed this frame. */
+	uint16 SimulatedInputSequence;
+	bool bHasNewInputSequence;
+
+	/** Whether or not predicted frames are being re-simulated right now. The physics body is left alone then. */
+	bool bIsResimulating;
+
+	/** Frames predicted by the owning client in the server-authoritative mode. */
+	FVehiclePredictionHistory PredictionHistory;
+
+	/** Input and movement modifiers that remote simulation uses. Taken from latest state or input frame. */
+	FVehicleInputState RemoteInput;
+	uint8 RemoteMovementModifiers;
+
+	/** Remote inputs reconstructed from received input histories. Consumed one per input step. */
+	FVehicleInputTimeline RemoteInputTimeline;
+
+	/** Time accumulated towards the next input step. */
+	float InputStepAccumulator;
+
+	/** History of the latest inputs sent by the controlling side. */
+	FVehicleInputHistory LocalInputHistory;
+
 	FVehiclePhysicsStateArray StateBuffer;
+
+	/** Received server states used by the interpolation smoothing mode. */
+	FVehicleJitterBuffer JitterBuffer;
 	
 	/** Tick that happens before physics. */
 	FActorComponentTickFunction PrePhysicsTick;
@@ -439,7 +649,38 @@ private:
 	FVehicleInputState CurrentInput;
 
 	/** Defines local time of last teleportation event. It ensures no physics states are applied, that are older than this information. */
-	float LastTeleportTime;
+	double LastTeleportTime;
+
+	/** Defines local time of last full physics state sent by the controlling side. */
+	double LastKeyframeTime;
+
+	/** State the vehicle has stayed at since the reference time. Used to decide when the vehicle can go net dormant. */
+	FVehiclePhysicsState DormancyReferenceState;
+	double DormancyReferenceTime;
+
+	/** Network telemetry of this vehicle. */
+	FVehicleNetTelemetry NetTelemetry;
+
+	/** Engine limits baked for the state validation, and queue the validation jobs hand their verdicts back through. Only valid on the server with state validation. */
+	TSharedPtr<const FVehicleValidationLimits, ESPMode::ThreadSafe> ValidationLimits;
+	TSharedPtr<FVehicleValidationResultQueue, ESPMode::ThreadSafe> ValidationResults;
+
+	/** Latest state received from the controlling client, validated states are compared against. */
+	FVehiclePhysicsState LastReceivedState;
+	bool bHasReceivedState;
+
+	/** State manager batching server states of this vehicle. Only valid on the server with batched state replication. */
+	TWeakObjectPtr<AArcadeVehicleStateManager> StateManager;
+
+	/** Recalculates whether or not we have control over this vehicle. */
+	void UpdateControlRole();
+
+	/** Updates control role and clears network data if controller of this vehicle has changed. */
+	void RefreshControlRole();
+
+	/** Called when owning pawn is possessed, unpossessed or its controller replicates. */
+	UFUNCTION()
+	void OnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
 
 	/** Controller current having control over this vehicle. Cached to diff changes. */
 	UPROPERTY()
@@ -0,0 +1,121 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ArcadeVehicleClockSyncComponent.generated.h"
+
+/** Single clock synchronization sample measured by the ping exchange. */
+struct FVehicleClockSample
+{
+	/** Local time the sample was measured at. */
+	double LocalTime;
+
+	/** Round trip time of the ping. */
+	double RoundTripTime;
+
+	/** Offset between server and local clock. */
+	double Offset;
+};
+
+/**
+	Component estimating offset and drift of the server clock on the client.
+	It should be added to the player controller. Owning client periodically pings the server with its local time,
+	and the server responds with its own time. Samples with the lowest round trip time are the least affected by queuing,
+	so only those are used to estimate offset and drift of the server clock.
+	Vehicles with bUseSynchronizedTime stamp their states with synchronized server time provided by this component.
+*/
+UCLASS(ClassGroup=(ArcadeVehicle), meta=(BlueprintSpawnableComponent))
+class ARCADEVEHICLESYSTEM_API UArcadeVehicleClockSyncComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UArcadeVehicleClockSyncComponent();
+
+	/** UActorComponent interface. */
+	void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	/** ~UActorComponent interface. */
+
+	/** Returns clock sync component of the local player in given world. Returns null on the server, where the local clock is the server clock. */
+	static const UArcadeVehicleClockSyncComponent* GetLocalClock(const UWorld* World);
+
+	/**
+	 * Converts local world time to server world time on given world, using the clock of the local player.
+	 * Until the clock is synchronized, or when there is none, server time is estimated from the replicated game state time and half RTT.
+	 */
+	static double LocalToServerTime(const UWorld* World, double LocalTime);
+
+	/** Converts server world time to local world time on given world. Inverse of the conversion above. */
+	static double ServerToLocalTime(const UWorld* World, double ServerTime);
+
+	/** Converts local world time to server world time. */
+	double LocalToServerTime(double LocalTime) const;
+
+	/** Converts server world time to local world time. */
+	double ServerToLocalTime(double ServerTime) const;
+
+	/** Returns current synchronized server time. */
+	UFUNCTION(BlueprintPure, Category = Networking)
+	double GetServerTime() const;
+
+	/** Checks if the clock has enough samples to be trusted. Until then, server time is estimated from the replicated game state time. */
+	UFUNCTION(BlueprintPure, Category = Networking)
+	bool IsSynchronized() const;
+
+	/** Returns the lowest round trip time measured in the current window, in seconds. */
+	UFUNCTION(BlueprintPure, Category = Networking)
+	double GetMinRoundTripTime() const;
+
+protected:
+	/** Rpc called on the server by the owning client with its local send time. */
+	UFUNCTION(Server, Unreliable)
+	void OnReceivePing_Server(double ClientTime);
+	virtual void OnReceivePing_Server_Implementation(double ClientTime);
+
+	/** Rpc called on the owning client with its send time and server time at the moment the ping was handled. */
+	UFUNCTION(Client, Unreliable)
+	void OnReceivePong_Client(double ClientTime, double ServerTime);
+	virtual void OnReceivePong_Client_Implementation(double ClientTime, double ServerTime);
+
+	/** Recalculates clock offset and drift using samples with the lowest round trip time. */
+	void UpdateEstimate();
+
+	/** Returns current local world time. */
+	double GetLocalTime() const;
+
+	/** Returns offset of the server clock estimated from the replicated game state time, which is half RTT old when it arrives. */
+	static double GetEstimatedOffset(const UWorld* World);
+
+public:
+	/** How often, in seconds, the client pings the server. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.01", ClampMin="0.01"))
+	float PingInterval;
+
+	/** How many latest samples are kept for the estimation. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="1", ClampMin="1"))
+	int32 SampleWindowSize;
+
+	/** How many samples are needed before the clock is synchronized. Limited by the sample window size. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="1", ClampMin="1"))
+	int32 MinSynchronizedSamples;
+
+	/** Fraction of the samples, with the lowest round trip time, used for the estimation. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0", UIMax="1.0", ClampMax="1.0"))
+	float BestSamplesFraction;
+
+private:
+	/** Window of the latest samples. */
+	TArray<FVehicleClockSample> Samples;
+
+	/** Estimated offset of the server clock at reference time, and its drift in seconds per second. */
+	double Offset;
+	double Drift;
+	double ReferenceTime;
+
+	/** Lowest round trip time of the current window. */
+	double MinRoundTripTime;
+
+	/** Time left until the next ping. */
+	float TimeToNextPing;
+};
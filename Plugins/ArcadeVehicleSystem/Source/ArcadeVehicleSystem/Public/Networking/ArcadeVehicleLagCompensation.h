@@ -0,0 +1,129 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ArcadeVehicleLagCompensation.generated.h"
+
+class UArcadeVehicleMovementComponentBase;
+
+/** Result of the rewound raycast against the vehicles. */
+USTRUCT(BlueprintType)
+struct ARCADEVEHICLESYSTEM_API FVehicleRewindHit
+{
+	GENERATED_BODY()
+
+	FVehicleRewindHit();
+
+	/** Vehicle that was hit. */
+	UPROPERTY(BlueprintReadOnly, Category=LagCompensation)
+	UArcadeVehicleMovementComponentBase* Vehicle;
+
+	/** Location where the ray entered the rewound bounds of the vehicle. */
+	UPROPERTY(BlueprintReadOnly, Category=LagCompensation)
+	FVector Location;
+
+	/** Distance from the start of the ray to the hit location. */
+	UPROPERTY(BlueprintReadOnly, Category=LagCompensation)
+	float Distance;
+};
+
+/** Single recorded transform of the vehicle. Bounds are constant per vehicle, so they are not stored per frame. */
+struct FVehicleRewindFrame
+{
+	/** Server time of this frame. */
+	double Time;
+
+	/** Transform of the vehicle mesh at this frame. */
+	FVector Location;
+	FQuat4f Rotation;
+};
+
+/**
+	Fixed-size ring of the latest frames of single vehicle, ordered by time. Frames are kept at fixed sample interval
+	regardless of the server tick rate, so the ring always covers about MaxFrames * SampleInterval seconds.
+*/
+struct FVehicleRewindHistory
+{
+	FVehicleRewindHistory();
+
+	/** Max number of frames kept for every vehicle. */
+	static constexpr int32 MaxFrames = 128;
+
+	/** Min time between two kept frames, in seconds. With 128 frames the history covers a bit over 2 seconds. */
+	static constexpr double SampleInterval = 1.0 / 60.0;
+
+	/**
+		Adds newest frame, overwriting the oldest one when the ring is full. Newest frame is replaced instead,
+		while it is less than sample interval apart from the frame before it.
+	*/
+	void AddFrame(const FVehicleRewindFrame& Frame);
+
+	/** Returns frame at given index, 0 being the oldest one. */
+	const FVehicleRewindFrame& GetFrame(int32 Index) const;
+
+	/** Returns transform of the vehicle at given time, interpolated between two closest frames with binary search. Returns false if there are no frames. */
+	bool GetTransformAtTime(double Time, FTransform& OutTransform) const;
+
+	/** Vehicle this history belongs to. */
+	TWeakObjectPtr<UArcadeVehicleMovementComponentBase> Vehicle;
+
+	/** Center and extent of the vehicle mesh bounds in its local space. */
+	FVector LocalCenter;
+	FVector LocalExtent;
+
+	/** Ring of the frames, index of the next frame to write and number of valid frames. */
+	FVehicleRewindFrame Frames[MaxFrames];
+	int32 NextFrame;
+	int32 NumFrames;
+};
+
+/**
+	Server-side lag compensation of the arcade vehicles. It records transforms of every vehicle on the server at fixed
+	sample interval, into fixed-size history, and allows to rewind vehicles to the time a client has seen them at. Useful for weapon hits,
+	ram detection or checkpoint disputes. Time of the query is the server world time, which clients can get from
+	ArcadeVehicleClockSyncComponent. Every query does a binary search in the history of each vehicle.
+	Console commands:
+	- avs.LagCompensation.Benchmark [Queries]
+*/
+UCLASS()
+class ARCADEVEHICLESYSTEM_API UArcadeVehicleLagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** UTickableWorldSubsystem interface. */
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override;
+	/** ~UTickableWorldSubsystem interface. */
+
+	/** Starts recording history of given vehicle. Called by the vehicles on the server. */
+	void RegisterVehicle(UArcadeVehicleMovementComponentBase* Vehicle);
+
+	/** Stops recording history of given vehicle. */
+	void UnregisterVehicle(UArcadeVehicleMovementComponentBase* Vehicle);
+
+	/** Returns transform of given vehicle at given server time. Returns false if there is no history for the vehicle. */
+	UFUNCTION(BlueprintCallable, Category=LagCompensation)
+	bool GetVehicleTransformAtTime(const UArcadeVehicleMovementComponentBase* Vehicle, double Time, FTransform& OutTransform) const;
+
+	/** Returns all vehicles which rewound bounds overlap given sphere at given server time. */
+	UFUNCTION(BlueprintCallable, Category=LagCompensation)
+	void OverlapVehiclesAtTime(const FVector& Location, float Radius, double Time, TArray<UArcadeVehicleMovementComponentBase*>& OutVehicles) const;
+
+	/** Traces a line against rewound bounds of the vehicles at given server time. Returns true and the closest hit if anything was hit. */
+	UFUNCTION(BlueprintCallable, Category=LagCompensation)
+	bool RaycastVehiclesAtTime(const FVector& Start, const FVector& End, double Time, FVehicleRewindHit& OutHit) const;
+
+	/** Returns vehicle which rewound bounds are the closest to given location at given server time, and the distance to them. */
+	UFUNCTION(BlueprintCallable, Category=LagCompensation)
+	UArcadeVehicleMovementComponentBase* FindNearestVehicleAtTime(const FVector& Location, double Time, float& OutDistance) const;
+
+	/** Runs given number of each query against all recorded vehicles and logs the timings. */
+	void RunBenchmark(int32 Queries) const;
+
+private:
+	/** Recorded history of every registered vehicle. Allocated separately, so the fixed-size rings don't move when vehicles come and go. */
+	TArray<TUniquePtr<FVehicleRewindHistory>> Histories;
+};
@@ -0,0 +1,58 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ArcadeVehicleNetHarness.generated.h"
+
+/**
+	Network test harness of the arcade vehicles. It is meant to be run in every process of a headless session,
+	for example dedicated server and several clients started with -nullrhi, using -ExecCmds to start it.
+	When running, it applies packet simulation to the net driver, drives all locally controlled vehicles
+	with scripted inputs and reports bandwidth, corrections, snaps and simulation time per role when stopped.
+	Bandwidth is reported both as the actual traffic of the net driver, and as the payload of the vehicles alone.
+	Console commands:
+	- avs.NetHarness.Start [LagMs] [JitterMs] [LossPercent]
+	- avs.NetHarness.Report
+	- avs.NetHarness.Stop
+*/
+UCLASS()
+class ARCADEVEHICLESYSTEM_API UArcadeVehicleNetHarnessSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UArcadeVehicleNetHarnessSubsystem();
+
+	/** UTickableWorldSubsystem interface. */
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override;
+	/** ~UTickableWorldSubsystem interface. */
+
+	/** Starts the harness with given packet simulation. It clears telemetry of all vehicles. */
+	void StartHarness(int32 LagMs, int32 JitterMs, int32 LossPercent);
+
+	/** Stops the harness, reports results and clears packet simulation. */
+	void StopHarness();
+
+	/** Logs results gathered since the harness was started. */
+	void ReportHarness() const;
+
+	/** Checks if the harness is currently running. */
+	bool IsHarnessRunning() const;
+
+private:
+	/** Applies packet simulation settings to the net driver of this world. */
+	void ApplyPacketSimulation(int32 LagMs, int32 JitterMs, int32 LossPercent);
+
+	/** Whether or not the harness is running. */
+	bool bIsRunning;
+
+	/** Time the harness was started at. */
+	double StartTime;
+
+	/** Total bytes received and sent by the net driver when the harness was started. */
+	uint32 StartBytesIn;
+	uint32 StartBytesOut;
+};
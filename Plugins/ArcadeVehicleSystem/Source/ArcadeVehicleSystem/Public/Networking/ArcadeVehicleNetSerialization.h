@@ -6,15 +6,57 @@
 #include "Engine/NetSerialization.h"
 #include "ArcadeVehicleNetSerialization.generated.h"
 
+/**
+ * Float quantization with compile-time bit count and range.
+ * Value is clamped to the range and packed into given number of bits. Even number of steps is used,
+ * so the middle of the range, zero for symmetric ranges, is represented exactly.
+ * Single bit quantization keeps either min or max value.
+ */
+template<int32 Bits, int32 MinValue, int32 MaxValue>
+struct TFloat_NetQuantize
+{
+	static_assert(Bits > 0 && Bits <= 24, "TFloat_NetQuantize supports from 1 up to 24 bits.");
+	static_assert(MinValue < MaxValue, "TFloat_NetQuantize requires min value to be lower than max value.");
+
+	/** Number of bits and quantization steps over the range. */
+	static constexpr uint32 NumBits = Bits;
+	static constexpr uint32 Steps = Bits > 1 ? (1U << Bits) - 2U : 1U;
+
+	static uint32 Quantize(float Value)
+	{
+		const float alpha = (FMath::Clamp(Value, static_cast<float>(MinValue), static_cast<float>(MaxValue)) - MinValue) / static_cast<float>(MaxValue - MinValue);
+		return static_cast<uint32>(FMath::RoundToInt(alpha * Steps));
+	}
+
+	static float Dequantize(uint32 QuantizedValue)
+	{
+		return MinValue + (MaxValue - MinValue) * (FMath::Min(QuantizedValue, Steps) / static_cast<float>(Steps));
+	}
+
+	/** Serializes given value using exactly Bits bits. */
+	static void SerializeValue(float& Value, FArchive& Ar)
+	{
+		uint32 quantizedValue = Ar.IsSaving() ? Quantize(Value) : 0U;
+		Ar.SerializeInt(quantizedValue, Steps + 1U);
+		if(Ar.IsLoading())
+		{
+			Value = Dequantize(quantizedValue);
+		}
+	}
+};
+
 /**
  * 8 bit float compression for networking.
- * 0 decimal places precision.
+ * Valid range: [-1, 1], with 1/127 precision.
  */
 USTRUCT(BlueprintType)
 struct ARCADEVEHICLESYSTEM_API FFloat_NetQuantize
 {
 	GENERATED_USTRUCT_BODY()
 
+	/** Quantization used by this structure. */
+	typedef TFloat_NetQuantize<8, -1, 1> FQuantizer;
+
 	FFloat_NetQuantize();
 	FFloat_NetQuantize(const float& InValue);
 	
@@ -34,7 +76,7 @@ struct ARCADEVEHICLESYSTEM_API FFloat_NetQuantize
 		return Value != rhs;
 	}
 
-	FFloat_NetQuantize operator*(const float& rhs)
+	FFloat_NetQuantize operator*(const float& rhs) const
 	{
 		FFloat_NetQuantize newFloat;
 		newFloat.Value = Value * rhs;
@@ -43,7 +85,7 @@ struct ARCADEVEHICLESYSTEM_API FFloat_NetQuantize
 	
 	FFloat_NetQuantize& operator*=(const float& rhs)
 	{
-		Value += rhs;
+		Value *= rhs;
 		return *this;
 	}
 
@@ -51,6 +93,12 @@ struct ARCADEVEHICLESYSTEM_API FFloat_NetQuantize
 	{
 		return Value;
 	}
+
+	/** Rounds the value to the one receivers get after serialization. */
+	void Quantize()
+	{
+		Value = FQuantizer::Dequantize(FQuantizer::Quantize(Value));
+	}
 	
 	/** Method for serializing the bits of this structure. */
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
@@ -75,6 +123,122 @@ struct TStructOpsTypeTraits<FFloat_NetQuantize> : public TStructOpsTypeTraitsBas
 	};
 };
 
+/**
+ * 12 bit float compression for networking.
+ * Valid range: [-1, 1], with 1/2047 precision. Fine enough for analog steering wheels.
+ */
+USTRUCT(BlueprintType)
+struct ARCADEVEHICLESYSTEM_API FFloat_NetQuantize12 : public FFloat_NetQuantize
+{
+	GENERATED_USTRUCT_BODY()
+
+	typedef TFloat_NetQuantize<12, -1, 1> FQuantizer;
+
+	FORCEINLINE FFloat_NetQuantize12()
+	{}
+
+	FORCEINLINE FFloat_NetQuantize12(const float& InValue)
+	: FFloat_NetQuantize(InValue)
+	{}
+
+	using FFloat_NetQuantize::operator=;
+
+	void Quantize()
+	{
+		Value = FQuantizer::Dequantize(FQuantizer::Quantize(Value));
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		FQuantizer::SerializeValue(Value, Ar);
+		bOutSuccess = true;
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FFloat_NetQuantize12> : public TStructOpsTypeTraitsBase2<FFloat_NetQuantize12>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithNetSharedSerialization = true,
+	};
+};
+
+/**
+ * Double precision time stamp for networking.
+ * Float seconds lose millisecond precision after a few hours of uptime, so the value is kept as double.
+ * Serialized as zigzag packed number of 0.1 millisecond ticks, so short relative times take only a couple of bytes,
+ * and absolute server times keep their precision regardless of the uptime.
+ */
+USTRUCT(BlueprintType)
+struct ARCADEVEHICLESYSTEM_API FTimeStamp_NetQuantize
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Number of ticks per second the time stamp is quantized to. */
+	static constexpr double TicksPerSecond = 10000.0;
+
+	FTimeStamp_NetQuantize();
+	FTimeStamp_NetQuantize(const double& InValue);
+
+	FTimeStamp_NetQuantize& operator=(const double& rhs)
+	{
+		Value = rhs;
+		return *this;
+	}
+
+	operator double() const
+	{
+		return Value;
+	}
+
+	double ToSeconds() const
+	{
+		return Value;
+	}
+
+	/** Conversion between seconds and quantized ticks. */
+	static int64 ToTicks(double Seconds)
+	{
+		return FMath::RoundToInt64(Seconds * TicksPerSecond);
+	}
+	static double FromTicks(int64 Ticks)
+	{
+		return Ticks / TicksPerSecond;
+	}
+
+	/** Zigzag encoding, so small negative values are packed as small as positive ones. */
+	static uint64 ZigZagEncode(int64 InValue)
+	{
+		return (static_cast<uint64>(InValue) << 1) ^ static_cast<uint64>(InValue >> 63);
+	}
+	static int64 ZigZagDecode(uint64 InValue)
+	{
+		return static_cast<int64>(InValue >> 1) ^ -static_cast<int64>(InValue & 1);
+	}
+
+	/** Method for serializing the bits of this structure. */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+protected:
+	/** Underlying time in seconds. */
+	UPROPERTY(BlueprintReadOnly, Category=Networking)
+	double Value;
+};
+
+/** Serialization functionality for net quantized time stamp. */
+template<>
+struct TStructOpsTypeTraits<FTimeStamp_NetQuantize> : public TStructOpsTypeTraitsBase2<FTimeStamp_NetQuantize>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithNetSharedSerialization = true,
+	};
+};
+
 FORCEINLINE FVector2D ClampVector2D(const FVector2D& V, const FVector2D& Min, const FVector2D& Max)
 {
 	return FVector2D(
@@ -208,4 +372,79 @@ struct TStructOpsTypeTraits<FVector2D_NetQuantize> : public TStructOpsTypeTraits
 		WithNetSerializer = true,
 		WithNetSharedSerialization = true,
 	};
+};
+
+/**
+ * Location compression for large worlds.
+ * Location is split into a coarse grid cell and a signed offset from its center. Cells are centered on the multiples of the cell size,
+ * so the origin cell spans half of the cell in every direction. Offset takes fixed number of bits per component,
+ * given by the cell size, with 1 cm precision anywhere in the world, the same as FVector_NetQuantize.
+ * With the default 250 m cell that is 15 bits per component, 46 bits in the origin cell. Cell costs only a single bit there,
+ * otherwise each of its components is sent in groups of 3 bits, so cells next to the origin add 12 bits.
+ * Cell size is set with avs.Net.LocationCellSize and has to match on the server and the clients.
+ */
+USTRUCT()
+struct ARCADEVEHICLESYSTEM_API FVector_NetQuantizeCell : public FVector
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Number of quantization steps of the offset per world unit. */
+	static constexpr double OffsetScale = 1.0;
+
+	FORCEINLINE FVector_NetQuantizeCell()
+	{}
+
+	explicit FORCEINLINE FVector_NetQuantizeCell(EForceInit E)
+	: FVector(E)
+	{}
+
+	FORCEINLINE FVector_NetQuantizeCell(double InX, double InY, double InZ)
+	: FVector(InX, InY, InZ)
+	{}
+
+	FORCEINLINE FVector_NetQuantizeCell(const FVector& InVec)
+	{
+		FVector::operator=(InVec);
+	}
+
+	/** Returns size of the grid cell in world units. */
+	static double GetCellSize();
+
+	/** Returns max quantized offset from the center of the cell, in either direction. */
+	static int32 GetOffsetSteps();
+
+	/** Returns number of bits of single offset. Offsets are sent biased by the max offset, so they are never negative. */
+	static uint32 GetOffsetBits();
+
+	/** Splits single component into its cell and quantized offset from the center of it. */
+	static void QuantizeComponent(double Value, int32& OutCell, int32& OutOffset);
+
+	/** Joins cell and quantized offset back into single component. */
+	static double DequantizeComponent(int32 Cell, int32 Offset);
+
+	/** Serializes single cell component. Zigzag value is sent in groups of 3 bits, each followed by a bit telling if another group follows. */
+	static void SerializeCell(FArchive& Ar, int32& Cell);
+
+	/** Zigzag encoding of the cell, so negative cells are packed as small as positive ones. */
+	static uint32 ZigZagEncode(int32 InValue)
+	{
+		return (static_cast<uint32>(InValue) << 1) ^ static_cast<uint32>(InValue >> 31);
+	}
+	static int32 ZigZagDecode(uint32 InValue)
+	{
+		return static_cast<int32>(InValue >> 1) ^ -static_cast<int32>(InValue & 1);
+	}
+
+	/** Method for serializing the bits of this structure. */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FVector_NetQuantizeCell> : public TStructOpsTypeTraitsBase2<FVector_NetQuantizeCell>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithNetSharedSerialization = true,
+	};
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #pragma once
 #include "CoreMinimal.h"
+#include "Templates/Function.h"
 #include "ArcadeVehicleNetSerialization.h"
 #include "ArcadeVehicleNetworkHelpers.generated.h"
 
@@ -46,14 +47,23 @@ struct ARCADEVEHICLESYSTEM_API FVehicleInputState
 	bool IsStabilizing() const;
 
 	static FVehicleInputState Lerp(const FVehicleInputState& A, const FVehicleInputState& B, float Alpha);
+
+	/** Checks if both inputs are the same. */
+	bool Equals(const FVehicleInputState& Other) const;
+
+	/** Serializes this input the same way it is serialized when replicated as a property. */
+	void SerializeCompact(FArchive& Ar);
+
+	/** Rounds all float inputs to the values receivers get after serialization. */
+	void Quantize();
 	
 	/** Acceleration input provided by this state. */
 	UPROPERTY(BlueprintReadOnly, Category=Input)
 	FFloat_NetQuantize AccelerationInput;
 
-	/** Turning input provided by this state. */
+	/** Turning input provided by this state. Uses finer precision, as steering wheels are analog. */
 	UPROPERTY(BlueprintReadOnly, Category=Input)
-	FFloat_NetQuantize TurningInput;
+	FFloat_NetQuantize12 TurningInput;
 
 	/** Additional float input, optional, for user to utilize. */
 	UPROPERTY(BlueprintReadOnly, Category=Input)
@@ -68,6 +78,70 @@ struct ARCADEVEHICLESYSTEM_API FVehicleInputState
 	uint8 InternalBitflags;
 };
 
+/**
+	Single frame of the input stream sent by the controlling side when using input stream replication mode.
+	It is a lot smaller than full physics state, so it can be sent every tick.
+*/
+USTRUCT()
+struct ARCADEVEHICLESYSTEM_API FVehicleInputFrame
+{
+	GENERATED_BODY()
+
+	FVehicleInputFrame();
+
+	/** Time stamp of this frame. Follows the same rules as the physics state time stamp. */
+	UPROPERTY()
+	FTimeStamp_NetQuantize TimeStamp;
+
+	/** Input that was used by the controlling side at this frame. */
+	UPROPERTY()
+	FVehicleInputState Input;
+
+	/** Movement modifiers that were active at this frame. */
+	UPROPERTY()
+	uint8 MovementModifiers;
+};
+
+/**
+	History of the latest inputs of the controlling side, newest first, with sequence number of the newest one.
+	It is sent with every unreliable packet, so receivers can recover inputs of lost packets.
+	Inputs repeating the newer one are serialized as a single bit.
+*/
+USTRUCT()
+struct ARCADEVEHICLESYSTEM_API FVehicleInputHistory
+{
+	GENERATED_BODY()
+
+	FVehicleInputHistory();
+
+	/** Max number of inputs the history can carry. */
+	static constexpr int32 MaxInputs = 8;
+
+	/** Adds newest input to the history keeping at most given number of inputs. */
+	void AddInput(const FVehicleInputState& Input, int32 HistorySize);
+
+	/** Method for serializing the bits of this structure. */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/** Sequence number of the newest input. */
+	UPROPERTY()
+	uint16 Sequence;
+
+	/** Latest inputs, newest first. */
+	UPROPERTY()
+	TArray<FVehicleInputState> Inputs;
+};
+
+/** Serialization functionality for input history. */
+template<>
+struct TStructOpsTypeTraits<FVehicleInputHistory> : public TStructOpsTypeTraitsBase2<FVehicleInputHistory>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
 /**
 	Grouped vehicle runtime information gathered
 	using the vehicle physics simulation.
@@ -107,15 +181,15 @@ struct ARCADEVEHICLESYSTEM_API FVehiclePhysicsState
 	
 	/** Server time stamp of this state. It defines how much time ago this state was calculated on its authoritative side. */
 	UPROPERTY()
-	float TimeStamp;
+	FTimeStamp_NetQuantize TimeStamp;
 
 	/** Input that was used to generate this state. */
 	UPROPERTY()
 	FVehicleInputState Input;
 	
-	/** Location of this vehicle at this state. */
+	/** Location of this vehicle at this state. Quantized relative to the grid cell, so it keeps its precision in large worlds. */
 	UPROPERTY()
-	FVector_NetQuantize Location;
+	FVector_NetQuantizeCell Location;
 
 	/** Rotation of this vehicle at this state. */
 	UPROPERTY()
@@ -135,6 +209,26 @@ private:
 	uint8 MovementModifiers;
 };
 
+/**
+	State simulated by the server in the server-authoritative mode, sent only to the owning client.
+	Sequence tells which input of the owning client the server has simulated last, so the client knows which of its predicted frames to compare it with.
+*/
+USTRUCT()
+struct ARCADEVEHICLESYSTEM_API FVehicleAuthoritativeState
+{
+	GENERATED_BODY()
+
+	FVehicleAuthoritativeState();
+
+	/** State of the vehicle simulated by the server. */
+	UPROPERTY()
+	FVehiclePhysicsState State;
+
+	/** Sequence of the last input of the owning client simulated by the server. */
+	UPROPERTY()
+	uint16 Sequence;
+};
+
 /** Special type of array that is completely static and replaces physics states at the bottom if its size is exceeded. */
 struct ARCADEVEHICLESYSTEM_API FVehiclePhysicsStateArray
 {
@@ -151,7 +245,7 @@ struct ARCADEVEHICLESYSTEM_API FVehiclePhysicsStateArray
 	bool PullState(FVehiclePhysicsState& OutState);
 
 	/** Returns most suitable state at given time. It uses advanced lerping for getting the best possible state. */
-	bool GetSuitableState(float InTime, FVehiclePhysicsState& OutState) const;
+	bool GetSuitableState(double InTime, FVehiclePhysicsState& OutState) const;
 	
 	/** Returns first state from buffer. */
 	FVehiclePhysicsState FirstState() const;
@@ -163,7 +257,7 @@ struct ARCADEVEHICLESYSTEM_API FVehiclePhysicsStateArray
 	void Clear();
 
 	/** Removes states from buffer that are older than given time. */
-	void ClearOldStates(float InTime);
+	void ClearOldStates(double InTime);
 
 private:
 	/** Max size of the buffer. */
@@ -173,6 +267,103 @@ private:
 	TArray<FVehiclePhysicsState> Buffer;
 };
 
+/**
+	Buffer of received states used to render remote vehicles with interpolation.
+	It measures arrival interval and its deviation, which define how far in the past vehicle should be rendered.
+	Time stamps of the states in this buffer are local times of the states.
+*/
+struct ARCADEVEHICLESYSTEM_API FVehicleJitterBuffer
+{
+	FVehicleJitterBuffer();
+
+	/** Adds state to the buffer keeping it sorted by time. Arrival time is used for measuring the jitter. */
+	void AddState(const FVehiclePhysicsState& State, double ArrivalTime);
+
+	/** Adds state that has not been received, e.g. current state of the local simulation, without measuring its arrival. */
+	void SeedState(const FVehiclePhysicsState& State);
+
+	/** Returns delay the buffer should be sampled with, based on measured mean arrival interval and its deviation. */
+	float GetDelay(float MinDelay, float MaxDelay, float DeviationMultiplier) const;
+
+	/**
+	 * Samples the buffer at given time. Uses cubic Hermite interpolation over location and linear velocity.
+	 * If the time is newer than the latest state, it is extrapolated for at most MaxExtrapolationTime.
+	 * Returns false if the buffer is empty. OutExtrapolationTime is how long the state was extrapolated for.
+	 */
+	bool Sample(double InTime, float MaxExtrapolationTime, FVehiclePhysicsState& OutState, float& OutExtrapolationTime) const;
+
+	/** Removes states that are not needed for sampling at given time anymore. */
+	void ClearOldStates(double InTime);
+
+	/** Clears states and measured jitter. */
+	void Clear();
+
+	/** Returns current number of states in this buffer. */
+	int32 Num() const;
+
+private:
+	/** Inserts state keeping the buffer sorted by time, dropping the oldest state if the buffer is full. */
+	void InsertState(const FVehiclePhysicsState& State);
+
+	/** Max number of states kept in the buffer. */
+	static constexpr int32 MaxBufferSize = 32;
+
+	/** Buffer of states sorted by time stamp. */
+	TArray<FVehiclePhysicsState> Buffer;
+
+	/** Arrival time of the last state. */
+	double LastArrivalTime;
+
+	/** Smoothed arrival interval and its mean deviation. */
+	float ArrivalInterval;
+	float ArrivalDeviation;
+
+	/** Number of arrivals measured so far. */
+	int32 ArrivalsCount;
+};
+
+/**
+	Timeline of the remote inputs reconstructed from received input histories.
+	Inputs of lost packets are recovered from the histories and consumed in order, one per input step.
+*/
+struct ARCADEVEHICLESYSTEM_API FVehicleInputTimeline
+{
+	FVehicleInputTimeline();
+
+	/** Max number of pending inputs the receiver should let build up. Inputs beyond it should be consumed right away, so the timeline doesn't build up latency. */
+	static constexpr int32 MaxPendingInputs = 8;
+
+	/** Adds inputs from the history that are newer than the last merged one. Returns number of the oldest inputs dropped, when nobody has consumed them for too long. */
+	int32 Merge(const FVehicleInputHistory& History);
+
+	/** Takes the oldest pending input. Returns false if there is no pending input. */
+	bool PullInput(FVehicleInputState& OutInput);
+
+	/** Returns sequence of the input taken last. */
+	uint16 GetPulledSequence() const;
+
+	/** Clears pending inputs and the last merged sequence. */
+	void Clear();
+
+	/** Returns current number of pending inputs. */
+	int32 Num() const;
+
+private:
+	/** Max number of buffered inputs. It is only reached when the inputs are not consumed at all. */
+	static constexpr int32 MaxBufferedInputs = 64;
+
+	/** Inputs waiting for simulation, oldest first, and their sequences. */
+	TArray<FVehicleInputState> PendingInputs;
+	TArray<uint16> PendingSequences;
+
+	/** Sequence of the last merged input. */
+	uint16 LastSequence;
+	bool bHasSequence;
+
+	/** Sequence of the input taken last. */
+	uint16 PulledSequence;
+};
+
 /**
  * Class storing network correction data.
  */
@@ -245,4 +436,189 @@ struct FVehiclePhysicsRuntime
 	float AdherenceMultiplier;
 	float RotationMultiplier;
 	uint8 MovementModifiers;
-};
\ No newline at end of file
+};
+
+/**
+	Single input step predicted by the owning client in the server-authoritative mode. Keeps everything the arcade step
+	needs to be re-simulated: the input, and the forces and ground contact the step has ended with.
+*/
+struct ARCADEVEHICLESYSTEM_API FVehiclePredictionFrame
+{
+	FVehiclePredictionFrame();
+
+	/** Sequence of the input this frame was simulated with. */
+	uint16 Sequence;
+
+	/** Length of this frame in seconds. Always the input step time. */
+	float DeltaTime;
+
+	/** State at the end of this frame's input step. */
+	FVehiclePhysicsState State;
+
+	/** Input this frame was simulated with. */
+	FVehicleInputState Input;
+
+	/** Forces and drift multipliers at the end of this frame. */
+	FVehicleForces Forces;
+	float AdherenceMultiplier;
+	float RotationMultiplier;
+
+	/** Movement modifiers active at this frame. */
+	uint8 MovementModifiers;
+
+	/** Wheels on the ground at this frame. Ground isn't traced again when re-simulating. */
+	int32 DriveWheelsOnGround;
+	int32 SteeringWheelsOnGround;
+};
+
+/**
+	History of the frames predicted by the owning client, oldest first, one frame per input step.
+	Rollback replaces the state of the acknowledged frame and re-simulates all of the newer frames with the given step.
+*/
+struct ARCADEVEHICLESYSTEM_API FVehiclePredictionHistory
+{
+	FVehiclePredictionHistory();
+
+	/** Max number of frames kept. Inputs older than this are never acknowledged in time anyway. */
+	static constexpr int32 MaxFrames = 64;
+
+	/** Adds newly predicted frame. */
+	void AddFrame(const FVehiclePredictionFrame& Frame);
+
+	/** Returns index of the frame with given sequence, or INDEX_NONE if it is not in the history. */
+	int32 FindFrame(uint16 Sequence) const;
+
+	/** Returns frame at given index. */
+	const FVehiclePredictionFrame& GetFrame(int32 Index) const;
+
+	/**
+	 * Replaces state of the frame at given index with the corrected one and re-simulates all of the newer frames, in order,
+	 * with given step. Step gets the already re-simulated previous frame, and updates the state of the frame it is given.
+	 * Frames older than the corrected one are dropped. Returns number of re-simulated frames.
+	 */
+	int32 Rollback(int32 Index, const FVehiclePhysicsState& CorrectedState, TFunctionRef<void(const FVehiclePredictionFrame& Previous, FVehiclePredictionFrame& Frame)> StepFrame);
+
+	/** Drops frames older than the one at given index. */
+	void ClearOldFrames(int32 Index);
+
+	/** Clears all of the frames. */
+	void Clear();
+
+	/** Returns current number of frames. */
+	int32 Num() const;
+
+private:
+	/** Predicted frames, oldest first. */
+	TArray<FVehiclePredictionFrame> Frames;
+};
+
+/**
+ * Structure storing network telemetry of the vehicle. Gathered at runtime for evaluating the replication quality.
+ * Nothing is gathered unless the telemetry is enabled.
+ */
+struct ARCADEVEHICLESYSTEM_API FVehicleNetTelemetry
+{
+	FVehicleNetTelemetry();
+
+	/** Number of buckets of the correction histogram. */
+	static constexpr int32 NumCorrectionBuckets = 8;
+
+	/** Returns upper limit of the correction histogram bucket. The last bucket has no limit. */
+	static float GetCorrectionBucketLimit(int32 Bucket);
+
+	/** Checks if the telemetry is gathered. It needs avs.Net.Telemetry enabled, in builds with stats or csv profiler. */
+	static bool IsEnabled();
+
+	/**
+	 * Returns size in bytes of given structure when serialized for networking, with the actual packing of its values.
+	 * Only the payload is counted, property handles, RPC and packet headers are not. Returns 0 when the telemetry is disabled.
+	 */
+	static int32 GetSerializedBytes(const FVehiclePhysicsState& State);
+	static int32 GetSerializedBytes(const FVehicleInputFrame& Frame);
+	static int32 GetSerializedBytes(const FVehicleInputHistory& History);
+
+	/** Clears all of the gathered data. */
+	void Reset();
+
+	/** Adds errors of received state. Location error goes to the histogram as well. */
+	void AddCorrection(float LocationError, float RotationError, float VelocityError);
+
+	/** Counts snaps of the vehicle. */
+	void AddLocationSnap();
+	void AddRotationSnap();
+
+	/** Counts network traffic of the vehicle. */
+	void AddBytesSent(int32 Bytes);
+	void AddBytesReceived(int32 Bytes);
+	void AddStateReceived();
+
+	/** Adds sample of the state buffer occupancy. */
+	void AddBufferSample(int32 Occupancy);
+
+	/** Adds time spent simulating this vehicle. Tick is split into several parts, only the first one starts a new tick. */
+	void AddSimulationTime(double Seconds, bool bNewTick);
+
+	/** Adds interpolated frame of the vehicle. */
+	void AddInterpolationSample(float Delay, float ExtrapolationTime);
+
+	/** Adds rollback of the predicted vehicle, with number of re-simulated frames and time spent on it. */
+	void AddRollback(int32 Frames, double Seconds);
+
+	/** Counts remote inputs dropped before they could be simulated. */
+	void AddDroppedInputs(int32 Count);
+
+	/** Returns received states per second since the last reset. */
+	float GetStatesPerSecond() const;
+
+	/** Histogram of the location errors of received states. */
+	int32 CorrectionHistogram[NumCorrectionBuckets];
+
+	/** Number of received states that were matched against local history. */
+	int32 CorrectionsCount;
+
+	/** Sums and maximums of the correction errors. Location and velocity in cm, rotation in degrees. */
+	float LocationErrorSum;
+	float LocationErrorMax;
+	float RotationErrorSum;
+	float RotationErrorMax;
+	float VelocityErrorSum;
+	float VelocityErrorMax;
+
+	/** Number of location and rotation snaps. */
+	int32 LocationSnaps;
+	int32 RotationSnaps;
+
+	/** Payload bytes of vehicle states and inputs sent and received by this machine. */
+	int64 BytesSent;
+	int64 BytesReceived;
+
+	/** Number of server states received. */
+	int32 StatesReceived;
+
+	/** State buffer occupancy samples. */
+	int64 BufferOccupancySum;
+	int32 BufferOccupancyMax;
+	int32 BufferSamples;
+
+	/** Total time spent simulating this vehicle and number of simulated ticks. */
+	double SimulationTime;
+	int32 SimulationTicks;
+
+	/** Number of rollbacks, re-simulated frames and time spent re-simulating them, in seconds. */
+	int32 RollbacksCount;
+	int32 RollbackFramesSum;
+	int32 RollbackFramesMax;
+	double RollbackTimeSum;
+	double RollbackTimeMax;
+
+	/** Number of remote inputs dropped before they could be simulated. */
+	int32 DroppedInputs;
+
+	/** Whether the vehicle is currently smoothed with interpolation, its current delay in seconds and number of extrapolated frames. */
+	bool bIsInterpolating;
+	float InterpolationDelay;
+	int32 ExtrapolatedFrames;
+
+	/** Time of the last reset. */
+	double StartTime;
+};
@@ -0,0 +1,215 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#pragma once
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "ArcadeVehicleReplicationGraph.generated.h"
+
+class UArcadeVehicleMovementComponentBase;
+
+/**
+	Single replication frequency bucket for the arcade vehicles.
+	Vehicles closer than MaxDistance to the viewer are replicated every ReplicationPeriodFrame frames.
+*/
+USTRUCT()
+struct ARCADEVEHICLESYSTEM_API FArcadeVehicleReplicationBucket
+{
+	GENERATED_BODY()
+
+	FArcadeVehicleReplicationBucket();
+	FArcadeVehicleReplicationBucket(float InMaxDistance, int32 InReplicationPeriodFrame);
+
+	/** Max distance from the viewer for this bucket. */
+	UPROPERTY(Config)
+	float MaxDistance;
+
+	/** How many replication frames pass between updates of the vehicle in this bucket. */
+	UPROPERTY(Config)
+	int32 ReplicationPeriodFrame;
+};
+
+/** Arcade vehicle registered in the replication graph. */
+struct FArcadeVehicleReplicationInfo
+{
+	TWeakObjectPtr<AActor> Actor;
+	TWeakObjectPtr<UArcadeVehicleMovementComponentBase> MovementComponent;
+};
+
+/** Arcade vehicle gathered for single connection. */
+struct FArcadeVehicleCompetitor
+{
+	/** Squared distance to the closest viewer of the connection. */
+	float DistanceSquared;
+
+	AActor* Actor;
+
+	/** How many replication frames pass between updates of the vehicle for the connection. */
+	int32 ReplicationPeriodFrame;
+};
+
+/**
+	Per-connection node that keeps nearest race competitors of the viewer always relevant,
+	no matter how far they are. It also assigns replication frequency of all the vehicles
+	for its connection, based on the distance to the viewer and speed of the vehicle.
+*/
+UCLASS()
+class ARCADEVEHICLESYSTEM_API UReplicationGraphNode_ArcadeVehicleCompetitors : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	/** UReplicationGraphNode interface. */
+	void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override {}
+	bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override { return false; }
+	void NotifyResetAllNetworkActors() override {}
+	void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+	/** ~UReplicationGraphNode interface. */
+
+	/** Graph that owns the vehicles registry. */
+	UPROPERTY()
+	class UArcadeVehicleReplicationGraph* OwningGraph;
+
+private:
+	/** List of the competitors gathered for the connection. */
+	FActorRepListRefView ReplicationActorList;
+};
+
+/**
+	Per-connection node that keeps the viewer, its pawn and its view target always relevant for the connection.
+*/
+UCLASS()
+class ARCADEVEHICLESYSTEM_API UReplicationGraphNode_ArcadeVehicleAlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+	/** UReplicationGraphNode interface. */
+	void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+	/** ~UReplicationGraphNode interface. */
+
+private:
+	/** List of the viewer actors gathered for the connection. */
+	FActorRepListRefView ViewerActorList;
+};
+
+/**
+	Global node of the actors relevant only to their owner. They are grouped by their owning connection once per frame,
+	so owner changes are picked up, and each connection only gathers its own group.
+*/
+UCLASS()
+class ARCADEVEHICLESYSTEM_API UReplicationGraphNode_ArcadeVehicleOwnerOnly : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UReplicationGraphNode_ArcadeVehicleOwnerOnly();
+
+	/** UReplicationGraphNode interface. */
+	void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	void NotifyResetAllNetworkActors() override;
+	void PrepareForReplication() override;
+	void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+	/** ~UReplicationGraphNode interface. */
+
+private:
+	/** All of the owner only actors. */
+	FActorRepListRefView Actors;
+
+	/** Owner only actors grouped by their owning connection. */
+	TMap<UNetConnection*, FActorRepListRefView> ConnectionActors;
+};
+
+/**
+	Replication graph policy for the arcade vehicles.
+	- Vehicles and other dynamic actors are spatialized using grid.
+	- Nearest race competitors of each connection are always relevant.
+	- Vehicle replication frequency is bucketed by distance and speed taken from the replicated physics state.
+	- Actors relevant only to their owner are gathered for their owning connection.
+	To use it, set ReplicationDriverClassName of the net driver to this class in DefaultEngine.ini.
+	Batched state replication of the vehicles is disabled while it is used, so the vehicles stay filtered per connection.
+	Console commands:
+	- avs.RepGraph.Benchmark [Connections] [Frames]
+*/
+UCLASS(Transient, Config=Engine)
+class ARCADEVEHICLESYSTEM_API UArcadeVehicleReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UArcadeVehicleReplicationGraph();
+
+	/** UReplicationGraph interface. */
+	void InitGlobalActorClassSettings() override;
+	void InitGlobalGraphNodes() override;
+	void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	/** ~UReplicationGraph interface. */
+
+	/** Returns all arcade vehicles registered in this graph. */
+	const TArray<FArcadeVehicleReplicationInfo>& GetVehicles() const;
+
+	/** Returns how many nearest competitors are always relevant for each connection. */
+	int32 GetNearestCompetitorsCount() const;
+
+	/** Returns replication period of the vehicle for given distance from the viewer and its speed in km/h. */
+	int32 GetVehicleReplicationPeriod(float Distance, float Speed) const;
+
+	/**
+	 * Gathers registered vehicles for connection with given viewers, with their replication period for the connection.
+	 * Vehicles viewed by the viewers are skipped. When nearest competitors are used, vehicles are sorted by distance.
+	 */
+	void GatherCompetitors(TArrayView<const FNetViewer> Viewers, TArray<FArcadeVehicleCompetitor, TInlineAllocator<128>>& OutCompetitors) const;
+
+	/**
+	 * Gathers competitors of given number of synthetic connections for given number of frames, and logs the timings.
+	 * Every connection views one of the registered vehicles, so it runs on the vehicles of the current session.
+	 */
+	void RunBenchmark(int32 Connections, int32 Frames) const;
+
+protected:
+	/** Size of the single spatialization grid cell. */
+	UPROPERTY(Config)
+	float GridCellSize;
+
+	/** Bias of the spatialization grid. It should be the lowest world coordinate we expect actors at. */
+	UPROPERTY(Config)
+	FVector2D GridSpatialBias;
+
+	/** Distance beyond which vehicles are not relevant, unless they are nearest competitors. */
+	UPROPERTY(Config)
+	float VehicleCullDistance;
+
+	/** How many nearest competitors are always relevant for each connection. */
+	UPROPERTY(Config)
+	int32 NearestCompetitorsCount;
+
+	/** Frequency buckets ordered by distance. Vehicles further than the last bucket use its period doubled. */
+	UPROPERTY(Config)
+	TArray<FArcadeVehicleReplicationBucket> FrequencyBuckets;
+
+	/** Speed in km/h above which the vehicle replication period is halved. */
+	UPROPERTY(Config)
+	float FastVehicleSpeed;
+
+	/** Speed in km/h below which the vehicle replication period is doubled. */
+	UPROPERTY(Config)
+	float SlowVehicleSpeed;
+
+private:
+	/** Grid node spatializing all of the dynamic actors. */
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	/** Node of actors that are always relevant for everyone. */
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	/** Node of actors that are relevant only to their owner. */
+	UPROPERTY()
+	UReplicationGraphNode_ArcadeVehicleOwnerOnly* OwnerOnlyNode;
+
+	/** All arcade vehicles registered in this graph. */
+	TArray<FArcadeVehicleReplicationInfo> Vehicles;
+};
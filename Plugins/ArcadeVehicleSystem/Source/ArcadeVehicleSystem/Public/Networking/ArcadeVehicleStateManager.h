@@ -0,0 +1,150 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "Networking/ArcadeVehicleNetworkHelpers.h"
+#include "ArcadeVehicleStateManager.generated.h"
+
+class UArcadeVehicleMovementComponentBase;
+struct FVehicleStateArray;
+
+/** Single vehicle entry of the batched states. */
+USTRUCT()
+struct ARCADEVEHICLESYSTEM_API FVehicleStateItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	FVehicleStateItem();
+
+	/** Fast array serializer interface. */
+	void PostReplicatedAdd(const FVehicleStateArray& InArraySerializer);
+	void PostReplicatedChange(const FVehicleStateArray& InArraySerializer);
+	/** ~Fast array serializer interface. */
+
+	/** Vehicle this state belongs to. */
+	UPROPERTY()
+	UArcadeVehicleMovementComponentBase* Vehicle;
+
+	/** Latest server state of the vehicle. */
+	UPROPERTY()
+	FVehiclePhysicsState State;
+};
+
+/** Fast array of all of the batched vehicle states. Only changed entries are sent in each net update. */
+USTRUCT()
+struct ARCADEVEHICLESYSTEM_API FVehicleStateArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FVehicleStateItem, FVehicleStateArray>(Items, DeltaParms, *this);
+	}
+
+	/** All of the batched vehicle states. */
+	UPROPERTY()
+	TArray<FVehicleStateItem> Items;
+};
+
+template<>
+struct TStructOpsTypeTraits<FVehicleStateArray> : public TStructOpsTypeTraitsBase2<FVehicleStateArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/** Single vehicle entry of the grid placement. */
+USTRUCT()
+struct ARCADEVEHICLESYSTEM_API FVehicleGridSlot
+{
+	GENERATED_BODY()
+
+	FVehicleGridSlot();
+
+	/** Vehicle placed in this slot. */
+	UPROPERTY()
+	UArcadeVehicleMovementComponentBase* Vehicle;
+
+	/** Transform of the slot. */
+	UPROPERTY()
+	FVector_NetQuantizeCell Location;
+
+	UPROPERTY()
+	FRotator Rotation;
+};
+
+/** Placement of many vehicles at once, applied by everyone at the same server time. */
+USTRUCT()
+struct ARCADEVEHICLESYSTEM_API FVehicleGridPlacement
+{
+	GENERATED_BODY()
+
+	/** Server world time at which the vehicles are teleported. */
+	UPROPERTY()
+	FTimeStamp_NetQuantize ApplyTime;
+
+	/** Slots of all of the placed vehicles. */
+	UPROPERTY()
+	TArray<FVehicleGridSlot> Slots;
+};
+
+/**
+	Optional manager that replicates server states of all vehicles with bBatchStateReplication enabled through a single actor channel.
+	It removes per-actor and per-property overhead of replicating each vehicle separately.
+	It is spawned automatically on the server by the first batched vehicle, so it doesn't have to be placed in the level.
+	States arriving to clients are handed over to the vehicles as if they were received through their own replication.
+	It also sends grid placements, which teleport many vehicles with single reliable message regardless of the batching.
+	Manager is always relevant and its states can't be filtered per connection, so cull distance and relevancy don't apply to them.
+	Batching is disabled when the net driver uses a replication driver, like the arcade vehicle replication graph.
+	Vehicles then replicate their own states.
+*/
+UCLASS(NotBlueprintable, NotPlaceable)
+class ARCADEVEHICLESYSTEM_API AArcadeVehicleStateManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AArcadeVehicleStateManager();
+
+	/** Applies grid placements once their time comes. */
+	void Tick(float DeltaSeconds) override;
+
+	/** Register members for syncing. */
+	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Returns state manager of the given world. On the server it is spawned if it doesn't exist yet. */
+	static AArcadeVehicleStateManager* Get(UWorld* World);
+
+	/** Sets latest server state of the vehicle, so it is sent with the next batch. Server only. */
+	void UpdateVehicleState(UArcadeVehicleMovementComponentBase* Vehicle, const FVehiclePhysicsState& State);
+
+	/** Removes vehicle from the batched states. Server only. */
+	void UnregisterVehicle(UArcadeVehicleMovementComponentBase* Vehicle);
+
+	/** Sends placement of given vehicles to everyone, to be applied given delay from now. Server only. */
+	void PlaceVehicles(const TArray<UArcadeVehicleMovementComponentBase*>& Vehicles, const TArray<FTransform>& Transforms, float Delay);
+
+protected:
+	/** Rpc called on everyone when the server places vehicles. */
+	UFUNCTION(NetMulticast, Reliable)
+	void OnReceivePlacement_Multicast(const FVehicleGridPlacement& Placement);
+	virtual void OnReceivePlacement_Multicast_Implementation(const FVehicleGridPlacement& Placement);
+
+	/** Teleports all of the vehicles of given placement. */
+	void ApplyPlacement(const FVehicleGridPlacement& Placement);
+
+private:
+	/** Received placements waiting for their time, with the local time to apply them at. */
+	TArray<TPair<double, FVehicleGridPlacement>> PendingPlacements;
+
+	/** Batched states of all of the registered vehicles. */
+	UPROPERTY(Replicated)
+	FVehicleStateArray VehicleStates;
+
+	/** Index of each registered vehicle in the batched states, so the vehicles are found without searching. Server only. */
+	TMap<UArcadeVehicleMovementComponentBase*, int32> VehicleIndices;
+};
@@ -0,0 +1,104 @@
+/** Created and owned by Furious Production LTD @ 2023. **/
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Networking/ArcadeVehicleNetworkHelpers.h"
+#include "ArcadeVehicleStateValidation.generated.h"
+
+struct FVehicleEngineSettings;
+
+/**
+	Enumerator that defines outcome of the server-side plausibility validation of the state sent by the controlling client.
+*/
+UENUM(BlueprintType)
+enum class VehicleStateVerdict : uint8
+{
+	/** State is plausible. */
+	Valid,
+	/** Speed of the state exceeds the max speed of the vehicle. */
+	ExceededSpeed,
+	/** Speed gained since the previous state exceeds what the engine can deliver. */
+	ExceededAcceleration,
+	/** Distance travelled since the previous state can't be covered with the speeds of both states. */
+	BrokeContinuity,
+	/** Forward speed doesn't match the re-simulation of the received inputs from the previous state. */
+	FailedResimulation
+};
+
+/**
+	Engine limits of the vehicle baked on the game thread, so the validation never touches curve objects on worker threads.
+*/
+struct ARCADEVEHICLESYSTEM_API FVehicleValidationLimits
+{
+	FVehicleValidationLimits();
+
+	/** Number of samples each curve is baked into. */
+	static constexpr int32 CurveSamples = 64;
+
+	/** Bakes curves and speeds of given engine settings. */
+	void Bake(const FVehicleEngineSettings& Engine, float InTolerance);
+
+	/** Returns linear interpolation of baked curve samples at given speed in km/h. */
+	float SampleCurve(const TArray<float>& Samples, float Speed) const;
+
+	/** Baked acceleration, reversing and braking curves, sampled evenly from 0 to SampleRange km/h. */
+	TArray<float> AccelerationSamples;
+	TArray<float> ReversingSamples;
+	TArray<float> BrakingSamples;
+	float SampleRange;
+
+	/** Max forward and reverse speed in km/h, before the max speed multiplier. */
+	float MaxSpeed;
+	float MaxReverseSpeed;
+
+	/** Relative tolerance applied to every check. */
+	float Tolerance;
+};
+
+/**
+	Everything single validation needs, copied on the game thread when the state arrives.
+*/
+struct ARCADEVEHICLESYSTEM_API FVehicleValidationJob
+{
+	FVehicleValidationJob();
+
+	/** Runs the validation. Safe to call from any thread. */
+	VehicleStateVerdict Validate() const;
+
+	/** Re-simulates forward speed from the previous state with the received inputs. Returns the highest forward speed reachable, in km/h. */
+	float ResimulateForwardSpeed(float DeltaTime) const;
+
+	/** Baked limits of the vehicle. Shared with the component, so it can rebake them without waiting for running jobs. */
+	TSharedPtr<const FVehicleValidationLimits, ESPMode::ThreadSafe> Limits;
+
+	/** Previous and received state of the vehicle. */
+	FVehiclePhysicsState PreviousState;
+	FVehiclePhysicsState State;
+	bool bHasPreviousState;
+
+	/** Received inputs, newest first, applied between the previous and received state. */
+	TArray<FVehicleInputState, TInlineAllocator<FVehicleInputHistory::MaxInputs>> Inputs;
+
+	/** Max speed multiplier and gravity of the vehicle at the time the state arrived. */
+	float MaxSpeedMultiplier;
+	float Gravity;
+};
+
+/**
+	Verdict of single validation, handed back to the game thread.
+*/
+struct FVehicleValidationResult
+{
+	VehicleStateVerdict Verdict;
+	double TimeStamp;
+};
+
+/** Queue of verdicts, written by the validation jobs and drained by the vehicle on the game thread. */
+typedef TQueue<FVehicleValidationResult, EQueueMode::Mpsc> FVehicleValidationResultQueue;
+
+namespace ArcadeVehicleStateValidation
+{
+	/** Launches given validation on a worker thread. Verdict is enqueued to given queue once it is done. */
+	ARCADEVEHICLESYSTEM_API void LaunchValidation(FVehicleValidationJob&& Job, const TSharedRef<FVehicleValidationResultQueue, ESPMode::ThreadSafe>& Results);
+}
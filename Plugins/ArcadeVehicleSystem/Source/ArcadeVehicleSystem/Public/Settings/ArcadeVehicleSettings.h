@@ -7,6 +7,33 @@
 
 class UCurveFloat;
 
+/**
+	Enumerator that defines what the controlling side of the vehicle sends over the network.
+*/
+UENUM(BlueprintType)
+enum class VehicleReplicationMode : uint8
+{
+	/** Full physics state is sent every tick. */
+	FullState,
+	/** Only inputs are sent every tick, full physics state is sent as a keyframe every KeyframeInterval. */
+	InputStream
+};
+
+/**
+	Enumerator that defines how remote vehicles are smoothed towards received server states.
+*/
+UENUM(BlueprintType)
+enum class VehicleSmoothingMode : uint8
+{
+	/** Remote vehicles simulate physics locally and are corrected towards the server state. */
+	ErrorCorrection,
+	/**
+	 * Remote vehicles are rendered from adaptive jitter buffer, using Hermite interpolation and bounded extrapolation.
+	 * Their body is kinematic meanwhile, so it pushes other bodies but isn't moved by them.
+	 */
+	Interpolation
+};
+
 /**
 	Grouped settings of the physics of the vehicle.
 */
@@ -368,6 +395,141 @@ struct ARCADEVEHICLESYSTEM_API FVehicleAdvancedSettings
 	bool bEnableFriction;
 };
 
+/**
+	Grouped settings of the vehicle networking.
+*/
+USTRUCT(BlueprintType)
+struct ARCADEVEHICLESYSTEM_API FVehicleNetworkSettings
+{
+	GENERATED_BODY()
+
+	FVehicleNetworkSettings();
+
+	/**
+	 * Defines what the controlling side sends every tick.
+	 * With input stream, remote machines simulate forward from the last keyframe using received inputs,
+	 * which significantly lowers bandwidth of the vehicle.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking)
+	VehicleReplicationMode ReplicationMode;
+
+	/** Defines how often, in milliseconds, full physics state keyframe is sent when using input stream replication mode. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0", EditCondition="ReplicationMode==VehicleReplicationMode::InputStream"))
+	float KeyframeInterval;
+
+	/**
+	 * When enabled, server states of this vehicle are not replicated through its own actor channel,
+	 * but batched together with the other vehicles by the arcade vehicle state manager.
+	 * Batched states are sent to every connection, so it is mutually exclusive with the replication graph.
+	 * When the net driver uses a replication driver, this is ignored and states are replicated per vehicle.
+	 * Trade-off: per-actor and per-property overhead is saved, but cull distance and relevancy no longer apply to the states.
+	 * Every connection receives every batched vehicle, and states of vehicles it doesn't have are discarded on arrival.
+	 * It pays off when most vehicles are relevant to most players, like in a race pack, and costs more on large maps with spread out vehicles.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking)
+	bool bBatchStateReplication;
+
+	/** Defines how this vehicle is smoothed on clients that do not control it. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking)
+	VehicleSmoothingMode SmoothingMode;
+
+	/** Minimum and maximum delay, in milliseconds, of the interpolation jitter buffer. Actual delay adapts to measured arrival jitter. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0", EditCondition="SmoothingMode==VehicleSmoothingMode::Interpolation"))
+	float MinInterpolationDelay;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0", EditCondition="SmoothingMode==VehicleSmoothingMode::Interpolation"))
+	float MaxInterpolationDelay;
+
+	/** Defines how many deviations of the arrival interval are added on top of the mean interval to size the jitter buffer. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0", EditCondition="SmoothingMode==VehicleSmoothingMode::Interpolation"))
+	float JitterDeviationMultiplier;
+
+	/** Defines for how long, in milliseconds, vehicle is extrapolated when states arrive late. After that it holds its last extrapolated state. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0", EditCondition="SmoothingMode==VehicleSmoothingMode::Interpolation"))
+	float MaxExtrapolationTime;
+
+	/**
+	 * When enabled, states and inputs are stamped with synchronized server time instead of the owner half RTT.
+	 * Requires ArcadeVehicleClockSyncComponent to be added to the player controller.
+	 * Until its clock is synchronized, server time is estimated from the replicated game state time and half RTT.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking)
+	bool bUseSynchronizedTime;
+
+	/**
+	 * Defines how many latest inputs are sent with every state or input packet, so inputs of lost packets can be recovered.
+	 * Value of 0 disables the input history.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0", ClampMin="0", UIMax="8", ClampMax="8"))
+	int32 InputHistorySize;
+
+	/**
+	 * Defines how many inputs per second the controlling side records into the input history.
+	 * Remote machines consume received inputs at the same rate, so every input covers the same time everywhere, regardless of the frame rates.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="1.0", ClampMin="1.0"))
+	float InputStepRate;
+
+	/**
+	 * When enabled, controlling side quantizes its inputs before the simulation the same way they are serialized.
+	 * All machines then simulate with identical inputs, so there is less error to correct.
+	 * Standalone games keep full precision of the inputs.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking)
+	bool bQuantizeInputsLocally;
+
+	/**
+	 * When enabled, vehicle controlled by the server puts its owner into net dormancy when it stays at rest.
+	 * It wakes up on input change, teleport, collision or max speed multiplier change.
+	 * Vehicles controlled by remote players never go dormant, as their server rpcs require an open actor channel.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking)
+	bool bEnableNetDormancy;
+
+	/** Defines for how long, in milliseconds, the state has to stay stable before the vehicle goes dormant. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0", EditCondition="bEnableNetDormancy"))
+	float NetDormancyDelay;
+
+	/**
+	 * Defines distance from the local view, in world units, beyond which remote vehicles stop simulating physics.
+	 * Their body becomes kinematic and is driven from the received states, like with the interpolation smoothing mode.
+	 * Value of 0 disables kinematic proxies.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0"))
+	float KinematicProxyDistance;
+
+	/**
+	 * When enabled, the server checks plausibility of every state sent by the controlling client on a worker thread.
+	 * Speed, acceleration, location continuity and re-simulated forward speed are checked against the engine settings.
+	 * Verdicts are reported through OnStateValidated, it is up to the game what to do with rejected states.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking)
+	bool bValidateClientStates;
+
+	/** Defines relative tolerance of the state validation checks. 0.25 allows the client to exceed every limit by 25%. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0", EditCondition="bValidateClientStates"))
+	float StateValidationTolerance;
+
+	/**
+	 * When enabled, vehicles controlled by remote players are simulated by the server from their inputs, and the server state is authoritative.
+	 * Owning client keeps predicting its vehicle locally, one frame per input step. When the server state differs from the prediction,
+	 * it rolls back to it and re-simulates its newer frames.
+	 * Owning client only sends inputs in this mode, so replication mode and state validation don't apply.
+	 * Movement modifiers are set by the server, modifiers sent by the client are ignored.
+	 * Experimental: the physics engine can't step single body, so the re-simulation only runs the arcade forces on kinematic state,
+	 * and takes effects of gravity, suspension and contacts from the prediction.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(DisplayName="Server Authoritative (Experimental)"))
+	bool bServerAuthoritative;
+
+	/**
+	 * Defines error between the server state and the prediction beyond which the owning client rolls back.
+	 * Compared in world units for location and linear velocity, and in degrees for rotation and angular velocity.
+	 * Server and client don't run the same frames, so it needs to leave room for the differences of their step clocks.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking, meta=(UIMin="0.0", ClampMin="0.0", EditCondition="bServerAuthoritative"))
+	float RollbackTolerance;
+};
+
 /** Groups all of vehicle settings. They are in one place so they are very easy to copy and pase if needed. */
 USTRUCT(BlueprintType)
 struct ARCADEVEHICLESYSTEM_API FVehicleSettings
@@ -395,6 +557,10 @@ struct ARCADEVEHICLESYSTEM_API FVehicleSettings
 	/** Advanced settings of the vehicle. Only if you know what you are doing. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Advanced)
 	FVehicleAdvancedSettings Advanced;
+
+	/** Networking settings of this vehicle. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Networking)
+	FVehicleNetworkSettings Network;
 };
 
 /**